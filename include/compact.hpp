@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+#include "json.hpp"
+#include "key_interner.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Read-only tree of 16-byte nodes, see CompactDocument. A JsonNode takes 40
+// bytes whatever it holds; a CompactNode is a type tag next to either up to
+// 14 bytes of string, stored inline, or a scalar or a pointer and a size, so
+// four nodes share a cache line. Nodes do not own what they point to: all of
+// it belongs to the document's arena, which makes nodes trivially copyable
+// handles that stay valid as long as the document.
+//
+// Thread safety: nothing in the tree changes after it is built, and reading
+// it takes no locks, touches no reference counts and writes no caches, so
+// any number of threads may read one document without synchronization.
+
+class CompactNode;
+class CompactField;
+
+namespace detail
+{
+class CompactBuilder;
+} // namespace detail
+
+// =============================================================================
+
+class CompactNode
+{
+public:
+    enum class Type : uint8_t
+    {
+        Null,
+        Bool,
+        Int64,
+        UInt64,
+        Double,
+        String,
+        Array,
+        Object
+    };
+
+    CompactNode() = default;
+    CompactNode(std::nullptr_t) {}
+    CompactNode(bool b);
+    CompactNode(const JsonNumber& number);
+
+    Type GetType() const { return type_; }
+
+    bool IsNull() const { return type_ == Type::Null; }
+    bool IsBool() const { return type_ == Type::Bool; }
+    bool IsNumber() const { return type_ == Type::Int64 || type_ == Type::UInt64 || type_ == Type::Double; }
+    bool IsString() const { return type_ == Type::String; }
+    bool IsArray() const { return type_ == Type::Array; }
+    bool IsObject() const { return type_ == Type::Object; }
+
+    // NOTE: all of these throw JsonException for a node of another type
+    JsonNull AsNull() const;
+    JsonBool AsBool() const;
+    JsonNumber AsNumber() const;
+    std::string_view AsString() const;
+    std::span<const CompactNode> AsArray() const;
+    std::span<const CompactField> AsObject() const;
+
+    // Number of items of an array or fields of an object
+    size_t Size() const;
+
+    const CompactNode& At(size_t index) const;
+    const CompactNode& operator[](size_t index) const { return AsArray()[index]; }
+
+    bool Has(std::string_view field) const { return Find(field) != nullptr; }
+    const CompactNode& Get(std::string_view field) const;
+    const CompactNode& operator[](std::string_view field) const { return Get(field); }
+
+    // NOTE: compare pointers, so only keys of a document parsed with the
+    // same JsonDeserializeOptions::key_interner are found
+    bool Has(InternedKey field) const { return Find(field) != nullptr; }
+    const CompactNode& Get(InternedKey field) const;
+    const CompactNode& operator[](InternedKey field) const { return Get(field); }
+
+    // Deep copy into a regular, self-contained JsonNode
+    JsonNode Materialize() const;
+
+private:
+    friend class detail::CompactBuilder;
+    friend class CompactField;
+
+    // Strings of up to INLINE_SIZE bytes are stored in the node itself
+    static constexpr size_t INLINE_SIZE = 14;
+    static constexpr uint8_t OUT_OF_LINE = 0xFF;
+
+    // NOTE: objects with more fields than this get an open-addressing index
+    // right after their fields, laid out like the one of JsonObject
+    static constexpr size_t INDEX_THRESHOLD = 8;
+
+    static size_t IndexCapacity(size_t count);
+
+    void Expect(Type type, const char* name) const;
+    void ExpectContainer() const;
+
+    // Text of a node known to be a string
+    std::string_view Chars() const
+    {
+        if (inline_size_ != OUT_OF_LINE)
+            return {data_, inline_size_};
+        return {GetPayload().chars_, GetSize()};
+    }
+
+    const CompactNode* Find(std::string_view field) const;
+    // NOTE: a linear scan, interned keys are compared by pointer
+    const CompactNode* Find(InternedKey field) const;
+
+private:
+    union Payload
+    {
+        bool bool_;
+        int64_t int_;
+        uint64_t uint_;
+        double double_;
+        const char* chars_;
+        const CompactNode* nodes_;
+        const CompactField* fields_;
+    };
+
+    // NOTE: everything but an inline string is a payload followed by a
+    // 32-bit size, both are read and written with memcpy so that they can
+    // share the bytes of the inline string
+    Payload GetPayload() const
+    {
+        Payload payload;
+        std::memcpy(&payload, data_, sizeof(payload));
+        return payload;
+    }
+
+    uint32_t GetSize() const
+    {
+        uint32_t size;
+        std::memcpy(&size, data_ + sizeof(Payload), sizeof(size));
+        return size;
+    }
+
+    void Set(Type type, Payload payload, uint32_t size = 0)
+    {
+        type_ = type;
+        std::memcpy(data_, &payload, sizeof(payload));
+        std::memcpy(data_ + sizeof(Payload), &size, sizeof(size));
+    }
+
+private:
+    alignas(8) char data_[INLINE_SIZE] = {};
+    uint8_t inline_size_ = OUT_OF_LINE;
+    Type type_ = Type::Null;
+};
+
+static_assert(sizeof(CompactNode) == 16);
+
+// =============================================================================
+
+class CompactField
+{
+public:
+    CompactField(CompactNode key, CompactNode value) :
+        key_(key),
+        value_(value)
+    {}
+
+    std::string_view Key() const { return key_.Chars(); }
+    const CompactNode& Value() const { return value_; }
+
+private:
+    friend class CompactNode;
+
+    // NOTE: a node, so that short keys are inline too; interned keys are
+    // always out of line and point into the interner
+    CompactNode key_;
+    CompactNode value_;
+};
+
+// =============================================================================
+
+// Owner of a CompactNode tree: parses `str` into nodes, string bodies and
+// container buffers that are bump-allocated from one arena and released
+// together with the document. The input is not needed after construction.
+//
+// Numbers are converted while parsing, JsonDeserializeOptions::raw_numbers
+// has no effect here.
+class CompactDocument
+{
+public:
+    explicit CompactDocument(std::string_view str, const JsonDeserializeOptions& options = {});
+
+    CompactDocument(CompactDocument&&) = default;
+    CompactDocument& operator=(CompactDocument&&) = default;
+
+    CompactDocument(const CompactDocument&) = delete;
+    CompactDocument& operator=(const CompactDocument&) = delete;
+
+    const CompactNode& Root() const { return root_; }
+
+private:
+    friend CompactDocument Freeze(const JsonNode& node);
+
+    CompactDocument();
+
+private:
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+    CompactNode root_;
+};
+
+// =============================================================================
+
+// Converts a built JsonNode tree into an immutable CompactDocument: the
+// same values, object fields in the same order, laid out contiguously in
+// one arena. Use it for data that is read often and from many threads, such
+// as configuration: unlike a JsonNode tree, whose raw numbers cache their
+// value on first read, the frozen form is safe to share without locks.
+// Raw numbers are converted here, so `node` must not be read by other
+// threads while it is frozen.
+CompactDocument Freeze(const JsonNode& node);
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
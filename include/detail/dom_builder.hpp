@@ -0,0 +1,101 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Event handler that assembles a JsonNode tree. Containers being filled are
+// kept on an explicit stack, the pending keys and the fields of open objects
+// on two more.
+class DomBuilder
+{
+public:
+    bool StartObject() { return Open(JsonObject{}); }
+    bool StartArray() { return Open(JsonArray{}); }
+
+    // NOTE: the fields are moved in only once the object is complete, so its
+    // vector is allocated once at its final size and never copies its keys
+    bool EndObject(size_t count)
+    {
+        JsonObject& object = stack_.back().AsObject();
+        object.Reserve(count);
+        for (auto it = fields_.end() - count; it != fields_.end(); ++it)
+            object.AddField(std::move(it->first), std::move(it->second));
+        fields_.erase(fields_.end() - count, fields_.end());
+        return Close();
+    }
+
+    bool EndArray(size_t) { return Close(); }
+
+    bool Key(std::string_view key)
+    {
+        keys_.emplace_back(key);
+        return true;
+    }
+
+    bool String(std::string_view str) { return Add(JsonNode{JsonString{str}}); }
+    bool Number(JsonNumber number) { return Add(JsonNode{std::move(number)}); }
+    bool Bool(bool b) { return Add(JsonNode{b}); }
+    bool Null() { return Add(JsonNode{nullptr}); }
+
+    JsonNode& Result() { return root_; }
+
+private:
+    template<typename T>
+    bool Open(T&& container)
+    {
+        stack_.emplace_back(std::forward<T>(container));
+        return true;
+    }
+
+    bool Close()
+    {
+        JsonNode node = std::move(stack_.back());
+        stack_.pop_back();
+        return Add(std::move(node));
+    }
+
+    bool Add(JsonNode&& node)
+    {
+        if (stack_.empty())
+        {
+            root_ = std::move(node);
+            return true;
+        }
+
+        JsonNode& parent = stack_.back();
+        if (parent.IsArray())
+        {
+            parent.AsArray().PushBack(std::move(node));
+        }
+        else
+        {
+            std::string key = std::move(keys_.back());
+            keys_.pop_back();
+            fields_.emplace_back(std::move(key), std::move(node));
+        }
+        return true;
+    }
+
+private:
+    std::vector<JsonNode> stack_;
+    std::vector<std::string> keys_;
+    std::vector<std::pair<std::string, JsonNode>> fields_;
+    JsonNode root_;
+};
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string_view>
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Decodes the escape sequences of a string body (the text between the quotes)
+// into `out`, \uXXXX escapes and surrogate pairs become UTF-8. The decoded
+// text is never longer than the input, so `out` may point to `str.data()` to
+// decode in place. Returns the decoded size, or std::string_view::npos if an
+// escape is malformed or a surrogate is unpaired.
+size_t DecodeEscapes(std::string_view str, char* out);
+
+// Same, for an `out` buffer of at least `str.size()` bytes that does not
+// overlap `str`: plain runs are copied with vector stores in the same pass
+// that looks for the next backslash.
+size_t DecodeEscapesCopy(std::string_view str, char* out);
+
+// Writes `str` as the body of a JSON string: `"`, `\` and control characters
+// are escaped, everything else, UTF-8 included, is written as is.
+void WriteEscaped(std::ostream& stream, std::string_view str);
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Read-only memory mapping of a whole file. Throws JsonException if the file
+// can not be opened, mapped or read.
+//
+// NOTE: only regular files are mapped. Pipes, character devices and /proc
+// files report no useful size, so they are read into a buffer instead.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view View() const
+    {
+        return data_ ? std::string_view{static_cast<const char*>(data_), size_} : std::string_view{buffer_};
+    }
+
+private:
+    // Reads what `fd` delivers until its end into `buffer_`
+    void Read(int fd, const std::filesystem::path& path);
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    std::string buffer_;
+};
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
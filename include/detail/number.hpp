@@ -0,0 +1,258 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Decimal number as written in the input: sign, up to 19 significant digits
+// and a power of ten
+struct DecimalNumber
+{
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+
+    bool is_integer = true;     // no fraction and no exponent
+    bool truncated = false;     // more than 19 significant digits, `mantissa` is unusable
+};
+
+// =============================================================================
+
+// Nearest double to the valid JSON number [first, last) with std::from_chars,
+// for the numbers ToDouble cannot handle. Numbers out of the double
+// range become zero or infinity.
+double ParseDoubleFallback(const char* first, const char* last);
+
+// Correctly rounded `number` with an Eisel-Lemire conversion, the exact
+// product of the mantissa and a 128-bit power of five decides the rounding.
+// Returns false in the rare cases where that product is not precise enough.
+bool ComputeDouble(const DecimalNumber& number, double& out);
+
+// =============================================================================
+
+inline bool IsDigit(char c)
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// =============================================================================
+
+// NOTE: SWAR digit loop, eight digits are checked and converted at once as a
+// little-endian 64-bit word (see fast_float's parse_eight_digits_unrolled)
+inline bool IsEightDigits(uint64_t word)
+{
+    return ((word + 0x4646464646464646) | (word - 0x3030303030303030)) & 0x8080808080808080 ? false : true;
+}
+
+inline uint64_t EightDigitsValue(uint64_t word)
+{
+    static constexpr uint64_t MASK = 0x000000FF000000FF;
+    static constexpr uint64_t MUL1 = 0x000F424000000064;    // 100 + (1000000 << 32)
+    static constexpr uint64_t MUL2 = 0x0000271000000001;    // 1 + (10000 << 32)
+
+    word -= 0x3030303030303030;
+    word = (word * 10) + (word >> 8);
+    return (((word & MASK) * MUL1) + (((word >> 16) & MASK) * MUL2)) >> 32;
+}
+
+// Appends the digits at `p` to `mantissa`, returns the end of the run
+inline const char* ParseDigits(const char* p, const char* last, uint64_t& mantissa)
+{
+    while (last - p >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        if (!IsEightDigits(word))
+            break;
+        mantissa = mantissa * 100000000 + EightDigitsValue(word);
+        p += 8;
+    }
+    for (; p != last && IsDigit(*p); p++)
+        mantissa = mantissa * 10 + (*p - '0');
+    return p;
+}
+
+// =============================================================================
+
+// Reads the number at the start of [first, last) into `number`, following the
+// JSON grammar: no leading `+`, no leading zeros, digits on both sides of `.`.
+// Returns the end of the number, or nullptr if there is none. Never throws
+// and does not depend on the locale.
+inline const char* ScanNumber(const char* first, const char* last, DecimalNumber& number)
+{
+    const char* p = first;
+    if (p != last && *p == '-')
+    {
+        number.negative = true;
+        p++;
+    }
+
+    const char* digits = p;
+    if (p == last || !IsDigit(*p))
+        return nullptr;
+    if (*p == '0')
+        p++;
+    else
+        p = ParseDigits(p, last, number.mantissa);
+    size_t digit_count = p - digits;
+
+    if (p != last && *p == '.')
+    {
+        number.is_integer = false;
+        const char* fraction = ++p;
+        p = ParseDigits(p, last, number.mantissa);
+        if (p == fraction)
+            return nullptr;
+        number.exponent = fraction - p;
+        digit_count += p - fraction;
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E'))
+    {
+        number.is_integer = false;
+        p++;
+        bool negative_exponent = false;
+        if (p != last && (*p == '-' || *p == '+'))
+            negative_exponent = *p++ == '-';
+        if (p == last || !IsDigit(*p))
+            return nullptr;
+
+        // NOTE: saturates, anything this far out is zero or infinity anyway
+        int64_t exponent = 0;
+        for (; p != last && IsDigit(*p); p++)
+            if (exponent < 0x10000)
+                exponent = exponent * 10 + (*p - '0');
+        number.exponent += negative_exponent ? -exponent : exponent;
+    }
+
+    // NOTE: more than 19 digits may have wrapped the mantissa around, unless
+    // they are leading zeros as in 0.000...
+    if (digit_count > 19)
+    {
+        const char* start = digits;
+        while (start != p && (*start == '0' || *start == '.'))
+        {
+            if (*start == '0')
+                digit_count--;
+            start++;
+        }
+        number.truncated = digit_count > 19;
+    }
+    return p;
+}
+
+// =============================================================================
+
+// Nearest double to `number`, scanned from [first, last).
+//
+// Integers are converted directly; decimals whose mantissa and power of ten
+// are both exact doubles take one multiplication or division (Clinger's fast
+// path); everything else goes through ComputeDouble, and only its failures
+// and numbers with more than 19 significant digits reach std::from_chars.
+inline double ToDouble(const DecimalNumber& number, const char* first, const char* last)
+{
+    static constexpr uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << 53;
+    static constexpr int64_t MAX_EXACT_POWER = 22;
+    static constexpr double POWERS_OF_TEN[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    if (number.truncated)
+        return ParseDoubleFallback(first, last);
+
+    double value;
+    if (number.is_integer)
+    {
+        // NOTE: the conversion of a 64-bit integer is correctly rounded
+        value = static_cast<double>(number.mantissa);
+    }
+    else if (number.mantissa <= MAX_EXACT_MANTISSA && number.exponent >= -MAX_EXACT_POWER &&
+             number.exponent <= MAX_EXACT_POWER)
+    {
+        value = static_cast<double>(number.mantissa);
+        if (number.exponent < 0)
+            value /= POWERS_OF_TEN[-number.exponent];
+        else
+            value *= POWERS_OF_TEN[number.exponent];
+    }
+    else
+    {
+        if (!ComputeDouble(number, value))
+            value = ParseDoubleFallback(first, last);
+        return value;
+    }
+
+    return number.negative ? -value : value;
+}
+
+// =============================================================================
+
+// Parses the number at the start of [first, last) as a double, see
+// ScanNumber for the grammar. Returns the end of the number or nullptr.
+inline const char* ParseDouble(const char* first, const char* last, double& out)
+{
+    DecimalNumber number;
+    const char* end = ScanNumber(first, last, number);
+    if (end != nullptr)
+        out = ToDouble(number, first, end);
+    return end;
+}
+
+// =============================================================================
+
+// Parses the number at the start of [first, last) in its narrowest exact
+// form: integers that fit into int64_t or uint64_t keep their value, the
+// rest (and -0) becomes the nearest double. Returns the end of the number or
+// nullptr.
+inline const char* ParseNumberExact(const char* first, const char* last, JsonNumber& out)
+{
+    static constexpr uint64_t MAX_NEGATED = uint64_t(1) << 63;
+
+    DecimalNumber number;
+    const char* end = ScanNumber(first, last, number);
+    if (end == nullptr)
+        return nullptr;
+
+    if (!number.is_integer || (number.negative && number.mantissa == 0))
+    {
+        out = ToDouble(number, first, end);
+        return end;
+    }
+
+    if (number.truncated)
+    {
+        // NOTE: up to 20 digits still fit into uint64_t, from_chars tells
+        uint64_t value;
+        auto [ptr, ec] = std::from_chars(first, end, value);
+        if (ec == std::errc{} && ptr == end)
+            out = value;
+        else
+            out = ToDouble(number, first, end);
+        return end;
+    }
+
+    if (!number.negative)
+        out = number.mantissa;
+    else if (number.mantissa <= MAX_NEGATED)
+        out = static_cast<int64_t>(0 - number.mantissa);
+    else
+        out = ToDouble(number, first, end);
+    return end;
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
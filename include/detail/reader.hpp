@@ -0,0 +1,603 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "detail/escape.hpp"
+#include "detail/number.hpp"
+#include "detail/simd.hpp"
+#include "detail/structural_index.hpp"
+#include "exceptions.hpp"
+#include "json.hpp"
+#include "options.hpp"
+#include "parse_error.hpp"
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// NOTE: only the four JSON whitespace characters, stage 1 classifies the
+// same set
+inline bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// =============================================================================
+
+inline std::string_view StripWhitespaces(std::string_view sv)
+{
+    size_t first_non_whitespace = SkipWhitespaces(sv, 0);
+
+    if (first_non_whitespace == sv.size())
+        return {};
+
+    // NOTE: trailing whitespace runs are short, no need for a vectorized kernel
+    size_t last_non_whitespace = sv.size() - 1;
+    while (IsWhitespace(sv[last_non_whitespace]))
+        --last_non_whitespace;
+
+    return sv.substr(first_non_whitespace, last_non_whitespace + 1 - first_non_whitespace);
+}
+
+// =============================================================================
+
+// Single position over the input: every byte is visited once, tokens never
+// copy or re-strip the remaining tail.
+class ScanCursor
+{
+public:
+    explicit ScanCursor(std::string_view str) : str_(str) {}
+
+    bool AtEnd() const { return pos_ >= str_.size(); }
+    char Peek() const { return str_[pos_]; }
+    size_t Position() const { return pos_; }
+
+    void Advance(size_t n = 1) { pos_ += n; }
+
+    // NOTE: most tokens are followed by at most one space, so the vectorized
+    // kernel is only entered for whitespace runs
+    void SkipWhitespaces()
+    {
+        if (pos_ < str_.size() && IsWhitespace(str_[pos_]))
+            pos_ = detail::SkipWhitespaces(str_, pos_ + 1);
+    }
+
+    // Position of the quote closing the string that starts at the cursor,
+    // `escaped` tells whether the string body contains a backslash
+    bool FindClosingQuote(size_t& close_quote_idx, bool& escaped) const
+    {
+        escaped = false;
+        close_quote_idx = FindQuoteOrBackslash(str_, pos_ + 1);
+        while (close_quote_idx < str_.size())
+        {
+            if (str_[close_quote_idx] == '"')
+                return true;
+            escaped = true;
+            close_quote_idx = FindQuoteOrBackslash(str_, close_quote_idx + 2);
+        }
+        return false;
+    }
+
+    bool Consume(char c)
+    {
+        if (AtEnd() || Peek() != c)
+            return false;
+        ++pos_;
+        SkipWhitespaces();
+        return true;
+    }
+
+    bool Consume(std::string_view literal)
+    {
+        if (!str_.substr(pos_).starts_with(literal))
+            return false;
+        pos_ += literal.size();
+        SkipWhitespaces();
+        return true;
+    }
+
+    const char* Current() const { return str_.data() + pos_; }
+    const char* End() const { return str_.data() + str_.size(); }
+
+    std::string_view Slice(size_t from, size_t to) const { return str_.substr(from, to - from); }
+    std::string_view Tail() const { return str_.substr(std::min(pos_, str_.size())); }
+
+private:
+    std::string_view str_;
+    size_t pos_ = 0;
+};
+
+// =============================================================================
+
+// Stage 2 cursor driven by the structural index: whitespace runs are jumped
+// over and string ends are looked up instead of being scanned byte by byte.
+class IndexedCursor
+{
+public:
+    IndexedCursor(std::string_view str, const std::vector<uint32_t>& positions) :
+        str_(str),
+        next_(positions.data())
+    {}
+
+    bool AtEnd() const { return pos_ >= str_.size(); }
+    char Peek() const { return str_[pos_]; }
+    size_t Position() const { return pos_; }
+
+    void Advance(size_t n = 1) { pos_ += n; }
+
+    // NOTE: a token that is directly followed by a non-whitespace byte stays
+    // put, so that garbage like `trues` is still seen by the grammar
+    void SkipWhitespaces()
+    {
+        if (pos_ < str_.size() && IsWhitespace(str_[pos_]))
+        {
+            Sync();
+            pos_ = *next_;
+        }
+    }
+
+    // NOTE: the index only keeps the quotes, backslashes are looked for in
+    // the string body
+    bool FindClosingQuote(size_t& close_quote_idx, bool& escaped)
+    {
+        Sync();
+        if (*next_ != pos_)
+            return false;
+        close_quote_idx = next_[1];
+        if (close_quote_idx >= str_.size())
+            return false;
+        escaped = std::memchr(str_.data() + pos_ + 1, '\\', close_quote_idx - pos_ - 1) != nullptr;
+        return true;
+    }
+
+    bool Consume(char c)
+    {
+        if (AtEnd() || Peek() != c)
+            return false;
+        ++pos_;
+        SkipWhitespaces();
+        return true;
+    }
+
+    bool Consume(std::string_view literal)
+    {
+        if (!str_.substr(pos_).starts_with(literal))
+            return false;
+        pos_ += literal.size();
+        SkipWhitespaces();
+        return true;
+    }
+
+    const char* Current() const { return str_.data() + pos_; }
+    const char* End() const { return str_.data() + str_.size(); }
+
+    std::string_view Slice(size_t from, size_t to) const { return str_.substr(from, to - from); }
+
+private:
+    // Moves to the first structural at or after the cursor, the trailing
+    // `str.size()` entry stops the loop
+    void Sync()
+    {
+        while (*next_ < pos_)
+            ++next_;
+    }
+
+private:
+    std::string_view str_;
+    const uint32_t* next_;
+    size_t pos_ = 0;
+};
+
+// =============================================================================
+
+// The JSON grammar. Tokens are reported to `Handler` as events, see
+// JsonEventHandler in events.hpp; every Parse* method returns false on
+// malformed input or when the handler asked to stop. Malformed input is
+// never reported by an exception: Error() and ErrorPosition() tell what went
+// wrong and where.
+template<typename Cursor, typename Handler>
+class Reader
+{
+public:
+    Reader(Cursor& cursor, Handler& handler, const JsonDeserializeOptions& options) :
+        cursor_(cursor),
+        handler_(handler),
+        options_(options)
+    {}
+
+    bool Stopped() const { return stopped_; }
+    bool TooDeep() const { return error_ == ParseErrorCode::TooDeep; }
+    ParseErrorCode Error() const { return error_; }
+    size_t ErrorPosition() const { return error_position_; }
+
+    // Strict mode validates the UTF-8 of every string, unless the caller
+    // already validated the whole input
+    void AssumeValidUtf8() { validate_utf8_ = false; }
+
+    // NOTE: nesting is tracked on a heap allocated stack instead of recursing
+    // into ParseArray/ParseObject, so deep input can not overflow the thread
+    // stack; `options.max_depth` bounds it
+    bool ParseValue()
+    {
+        stack_.clear();
+        while (true)
+        {
+            // Descend into the value, opening containers on the way
+            if (cursor_.AtEnd())
+                return Fail(ParseErrorCode::UnexpectedEnd);
+
+            char c = cursor_.Peek();
+            if (c == '[' || c == '{')
+            {
+                if (!Open(c == '{'))
+                    return false;
+                if (!cursor_.Consume(c == '{' ? '}' : ']'))
+                {
+                    if (c == '{' && !ParseFieldName())
+                        return false;
+                    continue;
+                }
+                if (!Close())
+                    return false;
+            }
+            else if (!ParseScalar(c))
+            {
+                return false;
+            }
+
+            // Climb up through the containers finished by this value
+            while (true)
+            {
+                if (stack_.empty())
+                    return true;
+
+                Frame& top = stack_.back();
+                top.count++;
+                if (cursor_.Consume(','))
+                {
+                    if (top.is_object && !ParseFieldName())
+                        return false;
+                    break;
+                }
+                if (!Expect(top.is_object ? '}' : ']') || !Close())
+                    return false;
+            }
+        }
+    }
+
+    bool ParseArray()
+    {
+        return (Peek('[') || Fail(UnexpectedToken())) && ParseValue();
+    }
+
+    bool ParseObject()
+    {
+        return (Peek('{') || Fail(UnexpectedToken())) && ParseValue();
+    }
+
+    bool ParseKey()
+    {
+        std::string_view key;
+        if (!ReadString(key))
+            return false;
+        return handler_.Key(key) || Stop();
+    }
+
+    bool ParseString()
+    {
+        std::string_view str;
+        if (!ReadString(str))
+            return false;
+        return handler_.String(str) || Stop();
+    }
+
+    bool ParseBool()
+    {
+        if (cursor_.Consume("true"))
+            return handler_.Bool(true) || Stop();
+        if (cursor_.Consume("false"))
+            return handler_.Bool(false) || Stop();
+        return Fail(ParseErrorCode::InvalidLiteral);
+    }
+
+    bool ParseNull()
+    {
+        if (!cursor_.Consume("null"))
+            return Fail(ParseErrorCode::InvalidLiteral);
+        return handler_.Null() || Stop();
+    }
+
+    bool ParseNumber()
+    {
+        if (options_.raw_numbers)
+            return ParseRawNumber();
+
+        JsonNumber number{0};
+        const char* end = ParseNumberExact(cursor_.Current(), cursor_.End(), number);
+        if (end == nullptr)
+            return ParseNonFiniteNumber();
+
+        if (options_.strict && number.IsDouble() && !std::isfinite(number.To<double>()))
+            return Fail(ParseErrorCode::NumberOutOfRange);
+
+        cursor_.Advance(end - cursor_.Current());
+        cursor_.SkipWhitespaces();
+        return handler_.Number(number) || Stop();
+    }
+
+private:
+    static constexpr bool IN_SITU = requires { requires Handler::IN_SITU; };
+
+    struct Frame
+    {
+        bool is_object;
+        size_t count;
+    };
+
+    bool Open(bool is_object)
+    {
+        if (stack_.size() >= options_.max_depth)
+            return Fail(ParseErrorCode::TooDeep);
+
+        cursor_.Advance();
+        cursor_.SkipWhitespaces();
+        stack_.push_back({is_object, 0});
+        return (is_object ? handler_.StartObject() : handler_.StartArray()) || Stop();
+    }
+
+    bool Close()
+    {
+        Frame top = stack_.back();
+        stack_.pop_back();
+        return (top.is_object ? handler_.EndObject(top.count) : handler_.EndArray(top.count)) || Stop();
+    }
+
+    // NOTE: the number is only checked against the grammar, strict mode still
+    // needs the value when it may be out of the double range
+    bool ParseRawNumber()
+    {
+        const char* begin = cursor_.Current();
+        DecimalNumber decimal;
+        const char* end = ScanNumber(begin, cursor_.End(), decimal);
+        if (end == nullptr)
+            return ParseNonFiniteNumber();
+
+        if (options_.strict && (decimal.exponent > 0 || decimal.truncated) &&
+            !std::isfinite(ToDouble(decimal, begin, end)))
+        {
+            return Fail(ParseErrorCode::NumberOutOfRange);
+        }
+
+        cursor_.Advance(end - begin);
+        cursor_.SkipWhitespaces();
+        return handler_.Number(JsonNumber::FromRaw({begin, end})) || Stop();
+    }
+
+    // NOTE: NaN and Infinity are not JSON, they are accepted outside of strict
+    // mode the way JavaScript writes them
+    bool ParseNonFiniteNumber()
+    {
+        bool numeric = Peek('-') || (!cursor_.AtEnd() && IsDigit(cursor_.Peek()));
+        ParseErrorCode error = numeric ? ParseErrorCode::InvalidNumber : UnexpectedToken();
+        if (options_.strict)
+            return Fail(error);
+
+        double number;
+        if (cursor_.Consume("NaN"))
+            number = std::numeric_limits<double>::quiet_NaN();
+        else if (cursor_.Consume("Infinity"))
+            number = std::numeric_limits<double>::infinity();
+        else if (cursor_.Consume("-Infinity"))
+            number = -std::numeric_limits<double>::infinity();
+        else
+            return Fail(error);
+
+        return handler_.Number(JsonNumber{number}) || Stop();
+    }
+
+    bool ParseFieldName()
+    {
+        return ParseKey() && Expect(':');
+    }
+
+    bool ParseScalar(char c)
+    {
+        switch (c)
+        {
+        case '"': return ParseString();
+        case 't': case 'f': return ParseBool();
+        case 'n': return ParseNull();
+        default: return ParseNumber();
+        }
+    }
+
+    // NOTE: strings with escapes are decoded into `scratch_`, which is
+    // reused, so the result only lives until the next string is read. UTF-8
+    // is validated on the raw body: escapes are ASCII and decode to
+    // well-formed UTF-8.
+    // Handlers that set IN_SITU own a mutable copy of the input, Buffer(),
+    // and get strings decoded in place there instead.
+    bool ReadString(std::string_view& out)
+    {
+        size_t close_quote_idx;
+        bool escaped;
+        if (!Peek('"'))
+            return Fail(UnexpectedToken());
+        if (!cursor_.FindClosingQuote(close_quote_idx, escaped))
+            return Fail(ParseErrorCode::UnterminatedString);
+
+        out = cursor_.Slice(cursor_.Position() + 1, close_quote_idx);
+        if (validate_utf8_ && !ValidateUtf8(out))
+            return Fail(ParseErrorCode::InvalidUtf8);
+        if (escaped)
+        {
+            char* decoded;
+            size_t size;
+            if constexpr (IN_SITU)
+            {
+                decoded = handler_.Buffer() + cursor_.Position() + 1;
+                size = DecodeEscapes(out, decoded);
+            }
+            else
+            {
+                scratch_.resize(out.size());
+                decoded = scratch_.data();
+                size = DecodeEscapesCopy(out, decoded);
+            }
+            if (size == std::string_view::npos)
+                return Fail(ParseErrorCode::InvalidEscape);
+            out = std::string_view{decoded, size};
+        }
+
+        cursor_.Advance(close_quote_idx + 1 - cursor_.Position());
+        cursor_.SkipWhitespaces();
+        return true;
+    }
+
+    bool Peek(char c) const
+    {
+        return !cursor_.AtEnd() && cursor_.Peek() == c;
+    }
+
+    // Consumes the structural `c` that the grammar requires here
+    bool Expect(char c)
+    {
+        return cursor_.Consume(c) || Fail(UnexpectedToken());
+    }
+
+    ParseErrorCode UnexpectedToken() const
+    {
+        return cursor_.AtEnd() ? ParseErrorCode::UnexpectedEnd : ParseErrorCode::UnexpectedCharacter;
+    }
+
+    // NOTE: the first failure is the one reported
+    bool Fail(ParseErrorCode error)
+    {
+        if (error_ == ParseErrorCode::None)
+        {
+            error_ = error;
+            error_position_ = cursor_.Position();
+        }
+        return false;
+    }
+
+    bool Stop()
+    {
+        stopped_ = true;
+        return false;
+    }
+
+private:
+    Cursor& cursor_;
+    Handler& handler_;
+    const JsonDeserializeOptions& options_;
+    std::vector<Frame> stack_;
+    std::string scratch_;
+    bool validate_utf8_ = options_.strict;
+    bool stopped_ = false;
+    ParseErrorCode error_ = ParseErrorCode::None;
+    size_t error_position_ = 0;
+};
+
+// =============================================================================
+
+// Fills `error` for a failure at `offset` of `str`, line and column included
+ParseError MakeParseError(std::string_view str, ParseErrorCode code, size_t offset);
+
+// Throws the JsonException describing `error`
+[[noreturn]] void ThrowParseError(std::string_view str, const ParseError& error, const JsonDeserializeOptions& options);
+
+// =============================================================================
+
+// Reads the whole document from `cursor`. Returns false if the handler stopped
+// parsing or on malformed input, which leaves its description in `error`.
+// Never throws on malformed input.
+template<typename Cursor, typename Handler>
+bool TryReadDocument(Cursor& cursor, std::string_view str, Handler& handler, const JsonDeserializeOptions& options,
+                     ParseError& error)
+{
+    cursor.SkipWhitespaces();
+    if (cursor.AtEnd())
+    {
+        error = MakeParseError(str, ParseErrorCode::EmptyInput, str.size());
+        return false;
+    }
+
+    // NOTE: one pass over the whole input is cheaper than one per string;
+    // invalid input is left to the per string checks, which find the string
+    Reader<Cursor, Handler> reader{cursor, handler, options};
+    if (options.strict && ValidateUtf8(str))
+        reader.AssumeValidUtf8();
+
+    if (reader.ParseValue())
+    {
+        if (cursor.AtEnd())
+            return true;
+        error = MakeParseError(str, ParseErrorCode::TrailingCharacters, cursor.Position());
+        return false;
+    }
+    if (!reader.Stopped())
+        error = MakeParseError(str, reader.Error(), reader.ErrorPosition());
+    return false;
+}
+
+// =============================================================================
+
+// Runs stage 1 and then the grammar over the whole document, see the Cursor
+// overload. `positions` is scratch space for the index, reuse it to save an
+// allocation per document when parsing many small ones.
+template<typename Handler>
+bool TryReadDocument(std::string_view str, Handler& handler, const JsonDeserializeOptions& options,
+                     std::vector<uint32_t>& positions, ParseError& error)
+{
+    // NOTE: the index fails on an unterminated string without telling where,
+    // scanning finds the exact spot, or an earlier error
+    if (str.size() > MAX_INDEXED_SIZE || !BuildStructuralIndex(str, positions))
+    {
+        ScanCursor cursor{str};
+        return TryReadDocument(cursor, str, handler, options, error);
+    }
+
+    IndexedCursor cursor{str, positions};
+    return TryReadDocument(cursor, str, handler, options, error);
+}
+
+// =============================================================================
+
+// Same as TryReadDocument, but throws JsonException on malformed input.
+// Returns false if the handler stopped parsing.
+template<typename Handler>
+bool ReadDocument(std::string_view str, Handler& handler, const JsonDeserializeOptions& options,
+                  std::vector<uint32_t>& positions)
+{
+    ParseError error;
+    if (TryReadDocument(str, handler, options, positions, error))
+        return true;
+    if (error.code != ParseErrorCode::None)
+        ThrowParseError(str, error, options);
+    return false;
+}
+
+// =============================================================================
+
+template<typename Handler>
+bool ReadDocument(std::string_view str, Handler& handler, const JsonDeserializeOptions& options)
+{
+    std::vector<uint32_t> positions;
+    return ReadDocument(str, handler, options, positions);
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+enum class SimdLevel
+{
+    Scalar,
+    Sse42,
+    Avx2,
+};
+
+// Best instruction set supported by the running CPU, detected once
+SimdLevel DetectSimdLevel();
+
+std::string_view ToString(SimdLevel level);
+
+// =============================================================================
+
+// Position of the first `"` or `\` at or after `pos`, `str.size()` if there is none
+size_t FindQuoteOrBackslash(std::string_view str, size_t pos);
+size_t FindQuoteOrBackslash(std::string_view str, size_t pos, SimdLevel level);
+
+// Position of the first non-whitespace byte at or after `pos`, `str.size()` if there is none
+size_t SkipWhitespaces(std::string_view str, size_t pos);
+size_t SkipWhitespaces(std::string_view str, size_t pos, SimdLevel level);
+
+// Copies the bytes from `pos` up to the first `\` to `out` and returns the
+// position of that backslash, `str.size()` if there is none. Whole vectors
+// are stored, so up to a vector's worth of bytes after the backslash is
+// written as well, but never more than `str.size() - pos` bytes in total.
+// `out` must not overlap `str`.
+size_t CopyUntilBackslash(std::string_view str, size_t pos, char* out);
+size_t CopyUntilBackslash(std::string_view str, size_t pos, char* out, SimdLevel level);
+
+// Whether `str` is well-formed UTF-8: no overlong forms, surrogates, code
+// points above U+10FFFF or truncated sequences
+bool ValidateUtf8(std::string_view str);
+bool ValidateUtf8(std::string_view str, SimdLevel level);
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
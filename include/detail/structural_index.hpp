@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "detail/simd.hpp"
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Stage 1 of ParseFrom: classifies the input in 64-byte blocks and collects
+// positions of every structural character (`{}[]:,`), every unescaped quote
+// (both opening and closing) and the first byte of every other token (numbers,
+// literals) outside of strings. The last element is always `str.size()`.
+//
+// Returns false when the input ends inside a string.
+bool BuildStructuralIndex(std::string_view str, std::vector<uint32_t>& positions,
+                          SimdLevel level = DetectSimdLevel());
+
+// Positions are 32-bit, larger inputs are parsed without an index
+inline constexpr size_t MAX_INDEXED_SIZE = UINT32_MAX;
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "key_interner.hpp"
+#include "view.hpp"
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Event handler that assembles a ViewNode tree over a mutable input buffer:
+// the reader decodes strings and keys in place, they are kept as views into
+// `buffer`, containers allocate from `resource`.
+class ViewBuilder
+{
+public:
+    // `buffer` is the input being read, the reader decodes strings into it
+    static constexpr bool IN_SITU = true;
+
+    ViewBuilder(char* buffer, std::pmr::memory_resource* resource, KeyInterner* interner = nullptr) :
+        buffer_(buffer),
+        resource_(resource),
+        interner_(interner)
+    {}
+
+    bool StartObject()
+    {
+        stack_.emplace_back(ViewObject{resource_});
+        return true;
+    }
+
+    bool StartArray()
+    {
+        stack_.emplace_back(ViewArray{resource_});
+        return true;
+    }
+
+    bool EndObject(size_t) { return Close(); }
+    bool EndArray(size_t) { return Close(); }
+
+    bool Key(std::string_view key)
+    {
+        keys_.push_back(interner_ ? interner_->Intern(key).View() : key);
+        return true;
+    }
+
+    bool String(std::string_view str) { return Add(ViewNode{str}); }
+    bool Number(JsonNumber number) { return Add(ViewNode{std::move(number)}); }
+    bool Bool(bool b) { return Add(ViewNode{b}); }
+    bool Null() { return Add(ViewNode{nullptr}); }
+
+    ViewNode& Result() { return root_; }
+    char* Buffer() const { return buffer_; }
+
+private:
+    bool Close()
+    {
+        ViewNode node = std::move(stack_.back());
+        stack_.pop_back();
+        return Add(std::move(node));
+    }
+
+    bool Add(ViewNode&& node)
+    {
+        if (stack_.empty())
+        {
+            root_ = std::move(node);
+            return true;
+        }
+
+        ViewNode::Value& parent = stack_.back().value_;
+        if (ViewArray* array = std::get_if<ViewArray>(&parent))
+        {
+            array->nodes_.push_back(std::move(node));
+        }
+        else
+        {
+            std::get<ViewObject>(parent).fields_.emplace_back(keys_.back(), std::move(node));
+            keys_.pop_back();
+        }
+        return true;
+    }
+
+private:
+    char* buffer_;
+    std::pmr::memory_resource* resource_;
+    KeyInterner* interner_;
+
+    std::vector<ViewNode> stack_;
+    std::vector<std::string_view> keys_;
+    ViewNode root_;
+};
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
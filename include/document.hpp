@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+
+#include "view.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Owner of everything one parse produces. The input is copied into a
+// monotonic arena and parsed in place there, so the text of every string and
+// key and the buffers of every array and object are bump-allocated from the
+// arena, and all of it is released at once with the document: no allocation
+// per node, and nothing to free node by node.
+//
+// The tree is made of the read-only ViewNode types of ParseInSitu; views
+// taken from it must not outlive the document. Numbers are stored inline,
+// except raw numbers (JsonDeserializeOptions::raw_numbers) longer than 16
+// bytes, which keep their text on the heap.
+class Document
+{
+public:
+    explicit Document(std::string_view str, const JsonDeserializeOptions& options = {});
+
+    Document(Document&&) = default;
+    Document& operator=(Document&& other);
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    const ViewNode& Root() const { return root_; }
+
+    bool IsString() const { return root_.IsString(); }
+    bool IsNumber() const { return root_.IsNumber(); }
+    bool IsBool() const { return root_.IsBool(); }
+    bool IsObject() const { return root_.IsObject(); }
+    bool IsArray() const { return root_.IsArray(); }
+    bool IsNull() const { return root_.IsNull(); }
+
+    std::string_view AsString() const { return root_.AsString(); }
+    const JsonNumber& AsNumber() const { return root_.AsNumber(); }
+    JsonBool AsBool() const { return root_.AsBool(); }
+    JsonNull AsNull() const { return root_.AsNull(); }
+    const ViewObject& AsObject() const { return root_.AsObject(); }
+    const ViewArray& AsArray() const { return root_.AsArray(); }
+
+private:
+    // NOTE: declared first, so that the tree is destroyed before the arena
+    // it lives in
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+    ViewNode root_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <concepts>
+#include <string_view>
+
+#include "detail/reader.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Receiver of parse events. Every method returns false to stop parsing.
+// Strings and keys arrive with their escape sequences decoded to UTF-8; they
+// are views into the input or into a reused buffer and are only valid during
+// the call.
+template<typename T>
+concept JsonEventHandler = requires(T handler, std::string_view str, JsonNumber number, bool b, size_t count)
+{
+    { handler.StartObject() } -> std::same_as<bool>;
+    { handler.Key(str) } -> std::same_as<bool>;
+    { handler.EndObject(count) } -> std::same_as<bool>;
+    { handler.StartArray() } -> std::same_as<bool>;
+    { handler.EndArray(count) } -> std::same_as<bool>;
+    { handler.String(str) } -> std::same_as<bool>;
+    { handler.Number(number) } -> std::same_as<bool>;
+    { handler.Bool(b) } -> std::same_as<bool>;
+    { handler.Null() } -> std::same_as<bool>;
+};
+
+// =============================================================================
+
+// Streams `str` into `handler` without building a JsonNode tree, using the
+// same tokenizer as ParseFrom. Returns false if the handler stopped parsing.
+// Throws JsonException on malformed input; events for the part of the input
+// before the error have already been delivered by then.
+template<JsonEventHandler Handler>
+bool ParseEvents(std::string_view str, Handler& handler, const JsonDeserializeOptions& options = {})
+{
+    return detail::ReadDocument(str, handler, options);
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
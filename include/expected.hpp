@@ -0,0 +1,73 @@
+#pragma once
+
+#include <utility>
+#include <variant>
+
+#include "exceptions.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Value-or-error result, the part of C++23 std::expected the library needs.
+// The project is built as C++20, where <expected> is not available; the
+// member names follow std::expected so that switching over later is a rename.
+
+template<typename E>
+class Unexpected
+{
+public:
+    explicit Unexpected(E error) : error_(std::move(error)) {}
+
+    const E& error() const { return error_; }
+
+private:
+    E error_;
+};
+
+// =============================================================================
+
+template<typename T, typename E>
+class Expected
+{
+public:
+    Expected(T value) : value_(std::in_place_index<0>, std::move(value)) {}
+    Expected(Unexpected<E> error) : value_(std::in_place_index<1>, error.error()) {}
+
+    bool has_value() const { return value_.index() == 0; }
+    explicit operator bool() const { return has_value(); }
+
+    // NOTE: unchecked like their std::expected counterparts, value() throws
+    T& operator*() { return *std::get_if<0>(&value_); }
+    const T& operator*() const { return *std::get_if<0>(&value_); }
+    T* operator->() { return std::get_if<0>(&value_); }
+    const T* operator->() const { return std::get_if<0>(&value_); }
+
+    T& value()
+    {
+        if (!has_value())
+            throw JsonException("Expected holds an error");
+        return **this;
+    }
+
+    const T& value() const
+    {
+        if (!has_value())
+            throw JsonException("Expected holds an error");
+        return **this;
+    }
+
+    const E& error() const { return *std::get_if<1>(&value_); }
+
+private:
+    std::variant<T, E> value_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <memory>
-#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -34,7 +37,174 @@ private:
     double n_;
 };
 
-using Number = NumberDouble;
+// =============================================================================
+
+// Number that keeps integers exact: int64_t, uint64_t or double with a type
+// tag. Non-negative integers that fit into int64_t are always stored as
+// Int64, so the type depends on the value and not on the C++ type it came
+// from, the same way the parser picks it.
+//
+// A raw number (see FromRaw and JsonDeserializeOptions::raw_numbers) keeps
+// its text as written and is converted the first time its value is read;
+// the serializer writes the text back unchanged.
+class NumberTagged
+{
+public:
+    enum class Type : uint8_t
+    {
+        Int64,
+        UInt64,
+        Double
+    };
+
+    template<std::signed_integral T>
+    NumberTagged(T x) :
+        type_(Type::Int64)
+    {
+        value_.int_ = x;
+    }
+
+    template<std::unsigned_integral T>
+    NumberTagged(T x) :
+        type_(x > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ? Type::UInt64 : Type::Int64)
+    {
+        if (type_ == Type::UInt64)
+            value_.uint_ = x;
+        else
+            value_.int_ = static_cast<int64_t>(x);
+    }
+
+    template<std::floating_point T>
+    NumberTagged(T x) :
+        type_(Type::Double)
+    {
+        value_.double_ = x;
+    }
+
+    NumberTagged(const NumberTagged& other) :
+        value_(other.value_),
+        type_(other.type_),
+        pending_(other.pending_)
+    {
+        if (other.IsRaw())
+            CopyRaw(other.RawText());
+    }
+
+    NumberTagged(NumberTagged&& other) noexcept :
+        value_(other.value_),
+        raw_(other.raw_),
+        raw_size_(other.raw_size_),
+        type_(other.type_),
+        pending_(other.pending_)
+    {
+        other.raw_size_ = 0;
+    }
+
+    NumberTagged& operator=(const NumberTagged& other)
+    {
+        if (this != &other)
+            *this = NumberTagged{other};
+        return *this;
+    }
+
+    NumberTagged& operator=(NumberTagged&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeRaw();
+            value_ = other.value_;
+            raw_ = other.raw_;
+            raw_size_ = other.raw_size_;
+            type_ = other.type_;
+            pending_ = other.pending_;
+            other.raw_size_ = 0;
+        }
+        return *this;
+    }
+
+    ~NumberTagged() { FreeRaw(); }
+
+    // `text` must be a valid JSON number, it is not checked until converted
+    static NumberTagged FromRaw(std::string_view text);
+
+    bool IsRaw() const { return raw_size_ != 0; }
+    std::string_view RawText() const { return {IsInline() ? raw_.inline_ : raw_.heap_, raw_size_}; }
+
+    Type GetType() const
+    {
+        Resolve();
+        return type_;
+    }
+
+    bool IsInteger() const { return GetType() != Type::Double; }
+    bool IsInt64() const { return GetType() == Type::Int64; }
+    bool IsUInt64() const { return GetType() == Type::UInt64; }
+    bool IsDouble() const { return GetType() == Type::Double; }
+
+    operator double() const { return To<double>(); }
+
+    // NOTE: converts from the stored type, so To<int64_t>() of an Int64 and
+    // To<uint64_t>() of a UInt64 are exact
+    template<typename T>
+    T To() const
+    {
+        Resolve();
+        switch (type_)
+        {
+        case Type::Int64: return static_cast<T>(value_.int_);
+        case Type::UInt64: return static_cast<T>(value_.uint_);
+        default: return static_cast<T>(value_.double_);
+        }
+    }
+
+private:
+    NumberTagged() = default;
+
+    void Resolve() const
+    {
+        if (pending_)
+            Convert();
+    }
+
+    // NOTE: caches the value inside the number, see raw_numbers
+    void Convert() const;
+
+    bool IsInline() const { return raw_size_ <= INLINE_RAW_SIZE; }
+    void CopyRaw(std::string_view text);
+
+    void FreeRaw()
+    {
+        if (!IsInline())
+            delete[] raw_.heap_;
+    }
+
+private:
+    union Value
+    {
+        int64_t int_;
+        uint64_t uint_;
+        double double_;
+    };
+
+    // NOTE: raw texts of up to 16 bytes, which is most numbers, are stored
+    // inline without an allocation. The whole number takes 32 bytes, no more
+    // than a std::string, so JsonNode does not get bigger.
+    static constexpr size_t INLINE_RAW_SIZE = 16;
+
+    union Raw
+    {
+        char inline_[INLINE_RAW_SIZE];
+        char* heap_;
+    };
+
+    mutable Value value_ = {};
+    Raw raw_ = {};
+    uint32_t raw_size_ = 0;             // 0 for numbers that are not raw
+    mutable Type type_ = Type::Int64;
+    mutable bool pending_ = false;      // raw text that is not converted yet
+};
+
+using Number = NumberTagged;
 
 // =============================================================================
 
@@ -66,6 +236,10 @@ concept JsonMovable = std::is_same_v<typename std::remove_reference<T>::type, Js
 
 // =============================================================================
 
+// Thread safety: a tree may be read by any number of threads while no thread
+// modifies it, with one exception: raw numbers (see
+// JsonDeserializeOptions::raw_numbers) cache their value on the first read.
+// Freeze() makes an immutable copy without that caveat.
 class JsonNode
 {
 public:
@@ -85,6 +259,9 @@ public:
     JsonNode(JsonNode&& node) = default;
     JsonNode(const JsonNode&) = delete;
 
+    JsonNode& operator=(JsonNode&& node) = default;
+    JsonNode& operator=(const JsonNode&) = delete;
+
     void SerializeToStream(std::ostream& stream = std::cout, JsonSerializeOptions options = JsonSerializeOptions{}) const;
 
     bool IsString() const { return value_.index() == 0; }
@@ -170,12 +347,17 @@ concept JsonObjetcItem = std::is_same_v<T, std::pair<const std::string, JsonNode
 
 // =============================================================================
 
+// Fields are kept in a vector in insertion order, which is also the order
+// of iteration and serialization. Small objects are searched by a linear
+// scan; once an object has more than INDEX_THRESHOLD fields an open-addressing
+// hash index of field positions is built and kept up to date by AddField.
+// When a key is added twice, the first value is kept.
 class JsonObject
 {
 public:
     using Key = std::string;
-    using Map = std::unordered_map<Key, JsonNode>;
-    // using Map = std::map<Key, JsonNode>;
+    using Field = std::pair<const Key, JsonNode>;
+    using Fields = std::vector<Field>;
 
     using CKeyPtr = const Key*;
 
@@ -187,33 +369,60 @@ public:
     template<typename... Args>
     JsonObject(Args&&... args)
     {
-        map_.reserve(sizeof...(Args));
-        ((map_.emplace(std::forward<Args>(args))), ...);
+        fields_.reserve(sizeof...(Args));
+        ((AddField(std::forward<Args>(args).first, std::forward<Args>(args).second)), ...);
     }
 
-    bool Has(const std::string& field);
-    JsonNode& Get(const std::string& field);
-    const JsonNode& Get(const std::string& field) const;
+    bool Has(std::string_view field) const { return Find(field) != nullptr; }
+    JsonNode& Get(std::string_view field);
+    const JsonNode& Get(std::string_view field) const;
 
-    JsonNode& operator[](const std::string& field) { return Get(field); }
-    const JsonNode& operator[](const std::string& field) const { return Get(field); }
+    JsonNode& operator[](std::string_view field) { return Get(field); }
+    const JsonNode& operator[](std::string_view field) const { return Get(field); }
 
     template<typename T>
-    void AddField(const std::string& name, T value)
+    void AddField(std::string name, T value)
     {
-        map_.insert(std::make_pair(name, std::forward<T>(value)));
+        uint64_t hash = 0;
+        if (Find(name, &hash))
+            return;
+        fields_.emplace_back(std::move(name), std::forward<T>(value));
+        Index(fields_.size() - 1, hash);
     }
 
+    // NOTE: the keys are const, so growing the vector copies each of them;
+    // whoever knows the number of fields up front should reserve it
+    void Reserve(size_t capacity);
     size_t Size() const;
 
-    Map::iterator begin() { return map_.begin(); }
-    Map::iterator end() { return map_.end(); }
+    Fields::iterator begin() { return fields_.begin(); }
+    Fields::iterator end() { return fields_.end(); }
 
-    Map::const_iterator begin() const { return map_.begin(); }
-    Map::const_iterator end() const { return map_.end(); }
+    Fields::const_iterator begin() const { return fields_.begin(); }
+    Fields::const_iterator end() const { return fields_.end(); }
 
 private:
-    Map map_;
+    // NOTE: up to this many fields a linear scan beats hashing the key
+    static constexpr size_t INDEX_THRESHOLD = 8;
+
+    // Stores the key hash in `hash` when it had to compute one, i.e. when the
+    // object is indexed, so that AddField does not hash the key twice
+    const JsonNode* Find(std::string_view field, uint64_t* hash = nullptr) const;
+
+    // Adds the field at `position` with key hash `hash` to the index, building
+    // the whole index when the object has just outgrown INDEX_THRESHOLD and
+    // growing it to keep it at most half full
+    void Index(size_t position, uint64_t hash);
+    void Rehash(size_t capacity);
+    void Insert(uint64_t hash, size_t position);
+
+private:
+    Fields fields_;
+
+    // NOTE: linear probing over a power-of-two table. A slot holds the upper
+    // half of the key hash and the field position + 1, 0 if it is empty, so
+    // most mismatches are rejected without touching the field.
+    std::vector<uint64_t> slots_;
 };
 
 // =============================================================================
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+class KeyInterner;
+
+// Handle of a key stored once in a KeyInterner. Two handles of the same
+// interner are equal exactly when their keys are, and are compared by
+// pointer. Valid as long as the interner.
+class InternedKey
+{
+public:
+    std::string_view View() const { return key_; }
+    const char* Data() const { return key_.data(); }
+
+    bool operator==(const InternedKey& other) const { return key_.data() == other.key_.data(); }
+
+private:
+    friend class KeyInterner;
+
+    explicit InternedKey(std::string_view key) : key_(key) {}
+
+private:
+    std::string_view key_;
+};
+
+// =============================================================================
+
+// Table of object keys shared by any number of documents and threads, see
+// JsonDeserializeOptions::key_interner. Keys are only ever added: every
+// distinct key is stored once, and stays at the same address until the
+// interner is destroyed, which must not happen before the documents that
+// use it are gone.
+//
+// NOTE: the table is split into shards by hash, each behind its own
+// reader-writer lock, so threads that look up keys that are already there
+// rarely touch the same lock
+class KeyInterner
+{
+public:
+    KeyInterner() = default;
+
+    KeyInterner(const KeyInterner&) = delete;
+    KeyInterner& operator=(const KeyInterner&) = delete;
+
+    InternedKey Intern(std::string_view key);
+
+    // Number of distinct keys
+    size_t Size() const;
+
+private:
+    struct Hash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_set<std::string, Hash, std::equal_to<>> keys;
+    };
+
+    static constexpr size_t SHARD_COUNT = 16;
+
+    std::array<Shard, SHARD_COUNT> shards_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// On-demand access to a JSON document: nothing is parsed up front, values are
+// validated and materialized only when the caller navigates into them, and
+// everything in between is skipped over without being converted.
+//
+// The document does not copy the input, so the input string must outlive the
+// document and every LazyValue/LazyObject/LazyArray taken from it, and those
+// must not outlive the document either. Lookups by key or index rescan the
+// enclosing container from its start, so read each field once and keep the
+// returned value around instead of repeating the lookup.
+
+class LazyDocument;
+class LazyObject;
+class LazyArray;
+
+// =============================================================================
+
+class LazyValue
+{
+public:
+    bool IsString() const { return Peek() == '"'; }
+    bool IsNumber() const;
+    bool IsBool() const { return Peek() == 't' || Peek() == 'f'; }
+    bool IsObject() const { return Peek() == '{'; }
+    bool IsArray() const { return Peek() == '['; }
+    bool IsNull() const { return Peek() == 'n'; }
+
+    JsonString AsString() const;
+    JsonNumber AsNumber() const;
+    JsonBool AsBool() const;
+    JsonNull AsNull() const;
+    LazyObject AsObject() const;
+    LazyArray AsArray() const;
+
+    // Parses the whole subtree into a regular JsonNode
+    JsonNode Materialize() const;
+
+    // Raw text of the value, the whole subtree is skipped over to find its end
+    std::string_view Raw() const;
+
+private:
+    friend class LazyDocument;
+    friend class LazyObject;
+    friend class LazyArray;
+
+    LazyValue(const LazyDocument* doc, size_t pos) : doc_(doc), pos_(pos) {}
+
+    char Peek() const;
+
+private:
+    const LazyDocument* doc_;
+    size_t pos_;
+};
+
+// =============================================================================
+
+class LazyObject
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<std::string_view, LazyValue>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        Iterator(const Iterator& other);
+        Iterator& operator=(const Iterator& other);
+
+        reference operator*() const { return field_; }
+        pointer operator->() const { return &field_; }
+
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const
+        {
+            return AtEnd() == other.AtEnd() && (AtEnd() || pos_ == other.pos_);
+        }
+
+    private:
+        friend class LazyObject;
+
+        // NOTE: end() is a sentinel at `npos`, equal to any iterator on `}`
+        Iterator(const LazyDocument* doc, size_t pos);
+
+        bool AtEnd() const;
+
+    private:
+        const LazyDocument* doc_;
+        size_t pos_;
+        std::string decoded_;   // key with its escapes decoded, if it has any
+        value_type field_;
+    };
+
+    bool Has(std::string_view field) const;
+    LazyValue Get(std::string_view field) const;
+
+    LazyValue operator[](std::string_view field) const { return Get(field); }
+
+    // NOTE: walks over the whole object
+    size_t Size() const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class LazyValue;
+
+    LazyObject(const LazyDocument* doc, size_t pos) : doc_(doc), pos_(pos) {}
+
+    bool Find(std::string_view field, size_t& value_pos) const;
+
+private:
+    const LazyDocument* doc_;
+    size_t pos_;    // first byte after `{`
+};
+
+// =============================================================================
+
+class LazyArray
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LazyValue;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const
+        {
+            return AtEnd() == other.AtEnd() && (AtEnd() || value_.pos_ == other.value_.pos_);
+        }
+
+    private:
+        friend class LazyArray;
+
+        // NOTE: end() is a sentinel at `npos`, equal to any iterator on `]`
+        Iterator(const LazyDocument* doc, size_t pos) : value_(doc, pos) {}
+
+        bool AtEnd() const { return value_.pos_ == std::string_view::npos || value_.Peek() == ']'; }
+
+    private:
+        LazyValue value_;
+    };
+
+    LazyValue At(size_t index) const;
+
+    LazyValue operator[](size_t index) const { return At(index); }
+
+    // NOTE: walks over the whole array
+    size_t Size() const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class LazyValue;
+
+    LazyArray(const LazyDocument* doc, size_t pos) : doc_(doc), pos_(pos) {}
+
+private:
+    const LazyDocument* doc_;
+    size_t pos_;    // first byte after `[`
+};
+
+// =============================================================================
+
+class LazyDocument
+{
+public:
+    explicit LazyDocument(std::string_view str, const JsonDeserializeOptions& options = {});
+
+    LazyDocument(const LazyDocument&) = delete;
+    LazyDocument& operator=(const LazyDocument&) = delete;
+
+    LazyValue Root() const { return LazyValue{this, root_}; }
+
+    bool IsString() const { return Root().IsString(); }
+    bool IsNumber() const { return Root().IsNumber(); }
+    bool IsBool() const { return Root().IsBool(); }
+    bool IsObject() const { return Root().IsObject(); }
+    bool IsArray() const { return Root().IsArray(); }
+    bool IsNull() const { return Root().IsNull(); }
+
+    JsonString AsString() const { return Root().AsString(); }
+    JsonNumber AsNumber() const { return Root().AsNumber(); }
+    JsonBool AsBool() const { return Root().AsBool(); }
+    JsonNull AsNull() const { return Root().AsNull(); }
+    LazyObject AsObject() const { return Root().AsObject(); }
+    LazyArray AsArray() const { return Root().AsArray(); }
+
+private:
+    friend class LazyValue;
+    friend class LazyObject;
+    friend class LazyArray;
+
+    std::string_view str_;
+    JsonDeserializeOptions options_;
+    size_t root_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 // =============================================================================
@@ -9,6 +10,10 @@ namespace mj
 
 // =============================================================================
 
+class KeyInterner;
+
+// =============================================================================
+
 struct JsonSerializeOptions
 {
     bool pretty = false;
@@ -23,7 +28,29 @@ struct JsonSerializeOptions
 
 struct JsonDeserializeOptions
 {
+    // Reject what is not JSON: NaN, Infinity, numbers out of the double
+    // range and strings that are not well-formed UTF-8
     bool strict = false;
+
+    // Maximum nesting of arrays and objects. Parsing itself does not recurse,
+    // but destroying and serializing a JsonNode tree does, so keep this
+    // bounded when the tree is built from untrusted input.
+    size_t max_depth = 1024;
+
+    // Keep every number as its original text (JsonNumber::FromRaw): it is
+    // converted the first time its value is read and serialized back as is.
+    // Cheaper when most numbers are passed through, and exact for numbers a
+    // double can not hold. The conversion is cached inside the number, so
+    // the first read is a write: do not read the same raw number from
+    // several threads at once.
+    bool raw_numbers = false;
+
+    // Object keys are looked up in this table and the tree refers to the
+    // stored copy, so a key is kept once however many documents repeat it,
+    // and lookups by InternedKey compare pointers. Used by the trees whose
+    // keys are views: ParseInSitu, Document and CompactDocument; ParseFrom
+    // keeps its own std::string keys. The interner must outlive the trees.
+    KeyInterner* key_interner = nullptr;
 };
 
 // =============================================================================
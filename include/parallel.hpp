@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+#include "thread_pool.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Parses newline-delimited JSON, one document per line, on the threads of
+// `pool`. The buffer is cut into chunks at line boundaries and the chunks are
+// parsed concurrently; the documents are returned in input order. Lines that
+// contain only whitespace are skipped. Throws JsonException for the first
+// malformed line, the message ends with its line number (counting from 1).
+std::vector<JsonNode> ParseNdjson(std::string_view str, ThreadPool& pool, const JsonDeserializeOptions& options = {});
+
+// Same, on a pool with one thread per core that is shared between calls, so
+// calls from different threads run one after another
+std::vector<JsonNode> ParseNdjson(std::string_view str, const JsonDeserializeOptions& options = {});
+
+// =============================================================================
+
+// Parses a document whose root is a big array on the threads of `pool`. The
+// array is cut at guessed top-level commas and the pieces are parsed
+// concurrently. A wrong guess, such as a comma inside a string or a nested
+// value, only costs time: that part is parsed again sequentially. The result
+// is the same as ParseFrom's. Other documents, and arrays under 1 MB, are
+// handed over to ParseFrom.
+JsonNode ParseArrayParallel(std::string_view str, ThreadPool& pool, const JsonDeserializeOptions& options = {});
+
+// Same, on the shared pool of ParseNdjson
+JsonNode ParseArrayParallel(std::string_view str, const JsonDeserializeOptions& options = {});
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+enum class ParseErrorCode : uint8_t
+{
+    None,
+    EmptyInput,
+    UnexpectedEnd,          // the input stops inside a value
+    UnexpectedCharacter,    // a value, `,`, `:` or a closing bracket was due
+    InvalidLiteral,         // misspelled true, false or null
+    InvalidNumber,
+    NumberOutOfRange,       // strict mode: the number does not fit a double
+    UnterminatedString,
+    InvalidEscape,
+    InvalidUtf8,            // strict mode only
+    TooDeep,                // deeper than JsonDeserializeOptions::max_depth
+    TrailingCharacters,     // anything but whitespace after the document
+};
+
+std::string_view ToString(ParseErrorCode code);
+
+// =============================================================================
+
+// Where and why parsing stopped. Lines and columns are 1-based, columns count
+// bytes rather than characters.
+struct ParseError
+{
+    ParseErrorCode code = ParseErrorCode::None;
+    size_t offset = 0;
+    size_t line = 0;
+    size_t column = 0;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
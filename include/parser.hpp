@@ -1,8 +1,11 @@
 #pragma once
 
+#include <filesystem>
 #include <string_view>
 
+#include "expected.hpp"
 #include "json.hpp"
+#include "parse_error.hpp"
 
 // =============================================================================
 
@@ -15,6 +18,19 @@ JsonNode ParseFrom(std::string_view str, const JsonDeserializeOptions& options =
 
 // =============================================================================
 
+// Same as ParseFrom, but malformed input is returned as a ParseError with its
+// position instead of being thrown; nothing is thrown while parsing. Meant
+// for inputs that are often invalid, where exceptions would dominate.
+Expected<JsonNode, ParseError> TryParse(std::string_view str, const JsonDeserializeOptions& options = {});
+
+// =============================================================================
+
+// Parses the file straight from a read-only memory mapping instead of reading
+// it into a string first. Throws JsonException if the file can not be read.
+JsonNode ParseFile(const std::filesystem::path& path, const JsonDeserializeOptions& options = {});
+
+// =============================================================================
+
 std::pair<mj::JsonNode, std::string_view> ParseArray(std::string_view str, const JsonDeserializeOptions& options);
 
 // =============================================================================
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Immutable JSON value with reference-counted, structurally shared
+// containers. Copying a node is cheap and never copies its subtree. The
+// modifiers (Set, Erase, PushBack, SetIn, EraseIn) leave the node alone and
+// return a new one: only the containers on the path to the change are
+// copied, as arrays of references to their keys and children, and every
+// other subtree is shared with the original. Snapshots can be read from any
+// number of threads.
+//
+// NOTE: objects keep their fields in insertion order and are searched by a
+// linear scan, like ViewObject
+
+class PersistentNode;
+
+// One step of a path into nested containers: an object key or an array index
+class PathItem
+{
+public:
+    PathItem(const char* key) : item_(std::string_view{key}) {}
+    PathItem(std::string_view key) : item_(key) {}
+    PathItem(const std::string& key) : item_(std::string_view{key}) {}
+    PathItem(size_t index) : item_(index) {}
+    PathItem(int index) : item_(static_cast<size_t>(index)) {}
+
+    bool IsKey() const { return item_.index() == 0; }
+    std::string_view Key() const { return std::get<std::string_view>(item_); }
+    size_t Index() const { return std::get<size_t>(item_); }
+
+private:
+    std::variant<std::string_view, size_t> item_;
+};
+
+using Path = std::initializer_list<PathItem>;
+
+// Object key, shared by every version of the object it was added to
+class PersistentKey
+{
+public:
+    PersistentKey(const char* key) : PersistentKey(std::string_view{key}) {}
+    PersistentKey(std::string_view key) : key_(std::make_shared<const std::string>(key)) {}
+    PersistentKey(const std::string& key) : PersistentKey(std::string_view{key}) {}
+
+    const std::string& Str() const { return *key_; }
+
+    bool operator==(std::string_view other) const { return *key_ == other; }
+
+private:
+    std::shared_ptr<const std::string> key_;
+};
+
+// =============================================================================
+
+class PersistentNode
+{
+public:
+    using Field = std::pair<PersistentKey, PersistentNode>;
+    using Fields = std::vector<Field>;
+    using Items = std::vector<PersistentNode>;
+
+    PersistentNode() : value_(nullptr) {}
+    PersistentNode(std::nullptr_t) : value_(nullptr) {}
+    PersistentNode(bool b) : value_(b) {}
+    PersistentNode(const char* str) : PersistentNode(std::string_view{str}) {}
+    PersistentNode(std::string_view str) : value_(std::make_shared<const std::string>(str)) {}
+    PersistentNode(const std::string& str) : PersistentNode(std::string_view{str}) {}
+
+    template<typename T>
+    requires std::is_arithmetic_v<T>
+    PersistentNode(T number) : value_(JsonNumber{number}) {}
+
+    // NOTE: a raw number is converted here, so readers never write its cache
+    PersistentNode(JsonNumber number) : value_(Resolved(std::move(number))) {}
+
+    // Deep copy of a regular JsonNode
+    explicit PersistentNode(const JsonNode& node);
+
+    static PersistentNode MakeObject(Fields fields = {});
+    static PersistentNode MakeArray(Items items = {});
+
+    bool IsString() const { return value_.index() == 0; }
+    bool IsNumber() const { return value_.index() == 1; }
+    bool IsBool() const { return value_.index() == 2; }
+    bool IsObject() const { return value_.index() == 3; }
+    bool IsArray() const { return value_.index() == 4; }
+    bool IsNull() const { return value_.index() == 5; }
+
+    const JsonString& AsString() const { return *std::get<StringPtr>(value_); }
+    const JsonNumber& AsNumber() const { return std::get<JsonNumber>(value_); }
+    JsonBool AsBool() const { return std::get<JsonBool>(value_); }
+    JsonNull AsNull() const { return std::get<JsonNull>(value_); }
+    const Fields& AsObject() const { return *std::get<FieldsPtr>(value_); }
+    const Items& AsArray() const { return *std::get<ItemsPtr>(value_); }
+
+    // Number of fields of an object or items of an array
+    size_t Size() const;
+
+    bool Has(std::string_view field) const { return Find(field) != nullptr; }
+    const PersistentNode& Get(std::string_view field) const;
+    const PersistentNode& operator[](std::string_view field) const { return Get(field); }
+
+    const PersistentNode& At(size_t index) const;
+    const PersistentNode& operator[](size_t index) const { return At(index); }
+
+    // Whether both nodes share the same string or container, or hold equal
+    // scalars; a cheap check whether a subtree was touched by a change
+    bool IsSameAs(const PersistentNode& other) const;
+
+    // Object with `field` set to `value`, added at the end if it is new
+    PersistentNode Set(std::string_view field, PersistentNode value) const;
+    // Array with the item at `index` replaced
+    PersistentNode Set(size_t index, PersistentNode value) const;
+    // Object without `field`, the same object if there is no such field
+    PersistentNode Erase(std::string_view field) const;
+    // Array without the item at `index`
+    PersistentNode Erase(size_t index) const;
+    // Array with `value` appended
+    PersistentNode PushBack(PersistentNode value) const;
+
+    // The same, applied to the container at the end of `path`, and the new
+    // root with copies of the containers on the path
+    PersistentNode SetIn(Path path, PersistentNode value) const;
+    PersistentNode EraseIn(Path path) const;
+
+    // Deep copy into a regular, self-contained JsonNode
+    JsonNode Materialize() const;
+
+private:
+    using StringPtr = std::shared_ptr<const std::string>;
+    using FieldsPtr = std::shared_ptr<const Fields>;
+    using ItemsPtr = std::shared_ptr<const Items>;
+
+    using Value = std::variant<
+        StringPtr,
+        JsonNumber,
+        JsonBool,
+        FieldsPtr,
+        ItemsPtr,
+        JsonNull
+    >;
+
+    static JsonNumber Resolved(JsonNumber number)
+    {
+        number.GetType();
+        return number;
+    }
+
+    const PersistentNode* Find(std::string_view field) const;
+    void CheckBounds(size_t index) const;
+
+    template<typename Modify>
+    PersistentNode ModifyIn(const PathItem* first, const PathItem* last, Modify&& modify) const;
+
+private:
+    Value value_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
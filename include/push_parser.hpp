@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "detail/dom_builder.hpp"
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Incremental parser for documents that arrive in pieces: chunks are handed
+// over with Feed() as they come and do not have to outlive the call, only the
+// token that straddles a chunk boundary (a string, a number or a literal) is
+// copied. The result is the same JsonNode that ParseFrom would build for the
+// concatenated input.
+//
+//     mj::PushParser parser;
+//     while (auto chunk = socket.Read())
+//         parser.Feed(*chunk);
+//     mj::JsonNode node = parser.Finish();
+class PushParser
+{
+public:
+    explicit PushParser(const JsonDeserializeOptions& options = {});
+
+    // Throws JsonException as soon as the input seen so far can not be
+    // continued into valid JSON
+    void Feed(std::string_view chunk);
+
+    // Throws JsonException if the document is incomplete. On success the
+    // parser is reset and may be fed the next document.
+    JsonNode Finish();
+
+private:
+    enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Nothing };
+    enum class Token { None, String, Scalar };
+
+    struct Container
+    {
+        bool is_object;
+        size_t count;
+    };
+
+    size_t ScanToken(std::string_view chunk, size_t pos);
+    void OnToken(std::string_view token);
+    void OnStructural(char c);
+    void OnValue();
+
+    [[noreturn]] void Fail(size_t offset) const;
+
+private:
+    JsonDeserializeOptions options_;
+    detail::DomBuilder builder_;
+    std::vector<Container> containers_;
+    Expect expect_ = Expect::Value;
+
+    Token token_kind_ = Token::None;
+    std::string token_;         // beginning of a token cut by a chunk boundary
+    size_t token_offset_ = 0;
+    bool escaped_ = false;      // chunk ended right after a backslash
+
+    size_t offset_ = 0;         // bytes fed before the current chunk
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -43,6 +43,8 @@ private:
         (stream_ << ... << args);
     }
 
+    void SerializeNonFinite(double n);
+
     void SerializeObjectField(const std::string& key, const JsonNode& node, bool &is_first);
 
 private:
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Read-only document flattened into one contiguous tape of 64-bit words, in
+// document order, with the bodies of strings and keys in a side buffer. An
+// array or object entry knows where its closing entry is, so skipping a
+// subtree is a single jump and the size of a container is read off in
+// constant time; walking the document is a linear scan of memory instead of
+// pointer chasing.
+//
+// Values are navigated through TapeValue/TapeObject/TapeArray cursors, which
+// are a document pointer and a tape index: cheap to copy, valid as long as
+// the document. Lookups by key or index scan the container from its start,
+// jumping over nested containers. The input is not needed after parsing.
+
+class TapeDocument;
+class TapeObject;
+class TapeArray;
+
+// =============================================================================
+
+class TapeValue
+{
+public:
+    bool IsString() const { return Tag() == '"'; }
+    bool IsNumber() const { return Tag() == 'l' || Tag() == 'u' || Tag() == 'd'; }
+    bool IsBool() const { return Tag() == 't' || Tag() == 'f'; }
+    bool IsObject() const { return Tag() == '{'; }
+    bool IsArray() const { return Tag() == '['; }
+    bool IsNull() const { return Tag() == 'n'; }
+
+    // NOTE: all of these throw JsonException for a value of another type
+    std::string_view AsString() const;
+    JsonNumber AsNumber() const;
+    JsonBool AsBool() const;
+    JsonNull AsNull() const;
+    TapeObject AsObject() const;
+    TapeArray AsArray() const;
+
+    // Deep copy into a regular, self-contained JsonNode
+    JsonNode Materialize() const;
+
+private:
+    friend class TapeDocument;
+    friend class TapeObject;
+    friend class TapeArray;
+
+    TapeValue(const TapeDocument* doc, size_t index) : doc_(doc), index_(index) {}
+
+    char Tag() const;
+    void Expect(char tag, const char* name) const;
+
+    // Index of the entry right after this value and its subtree
+    size_t Next() const;
+
+private:
+    const TapeDocument* doc_;
+    size_t index_;
+};
+
+// =============================================================================
+
+class TapeObject
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<std::string_view, TapeValue>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const { return field_; }
+        pointer operator->() const { return &field_; }
+
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const { return index_ == other.index_; }
+
+    private:
+        friend class TapeObject;
+
+        Iterator(const TapeDocument* doc, size_t index);
+
+    private:
+        const TapeDocument* doc_;
+        size_t index_;  // of the key
+        value_type field_;
+    };
+
+    bool Has(std::string_view field) const { return Find(field, nullptr); }
+    TapeValue Get(std::string_view field) const;
+
+    TapeValue operator[](std::string_view field) const { return Get(field); }
+
+    size_t Size() const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class TapeValue;
+
+    TapeObject(const TapeDocument* doc, size_t index) : doc_(doc), index_(index) {}
+
+    bool Find(std::string_view field, size_t* value_index) const;
+
+private:
+    const TapeDocument* doc_;
+    size_t index_;  // of `{`
+};
+
+// =============================================================================
+
+class TapeArray
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TapeValue;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+
+        Iterator& operator++()
+        {
+            value_.index_ = value_.Next();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return value_.index_ == other.value_.index_; }
+
+    private:
+        friend class TapeArray;
+
+        Iterator(const TapeDocument* doc, size_t index) : value_(doc, index) {}
+
+    private:
+        TapeValue value_;
+    };
+
+    // NOTE: jumps over the items before `index`
+    TapeValue At(size_t index) const;
+
+    TapeValue operator[](size_t index) const { return At(index); }
+
+    size_t Size() const;
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    friend class TapeValue;
+
+    TapeArray(const TapeDocument* doc, size_t index) : doc_(doc), index_(index) {}
+
+private:
+    const TapeDocument* doc_;
+    size_t index_;  // of `[`
+};
+
+// =============================================================================
+
+class TapeDocument
+{
+public:
+    explicit TapeDocument(std::string_view str, const JsonDeserializeOptions& options = {});
+
+    TapeDocument(const TapeDocument&) = delete;
+    TapeDocument& operator=(const TapeDocument&) = delete;
+
+    TapeValue Root() const { return TapeValue{this, 0}; }
+
+    bool IsString() const { return Root().IsString(); }
+    bool IsNumber() const { return Root().IsNumber(); }
+    bool IsBool() const { return Root().IsBool(); }
+    bool IsObject() const { return Root().IsObject(); }
+    bool IsArray() const { return Root().IsArray(); }
+    bool IsNull() const { return Root().IsNull(); }
+
+    std::string_view AsString() const { return Root().AsString(); }
+    JsonNumber AsNumber() const { return Root().AsNumber(); }
+    JsonBool AsBool() const { return Root().AsBool(); }
+    JsonNull AsNull() const { return Root().AsNull(); }
+    TapeObject AsObject() const { return Root().AsObject(); }
+    TapeArray AsArray() const { return Root().AsArray(); }
+
+    // Number of 64-bit words on the tape and bytes in the string buffer
+    size_t TapeSize() const { return tape_.size(); }
+    size_t StringsSize() const { return strings_.size(); }
+
+private:
+    friend class TapeValue;
+    friend class TapeObject;
+    friend class TapeArray;
+
+    // Entries are a tag character in the top byte and a 56-bit payload:
+    //   `{` `[`           index of the matching closing entry
+    //   `}` `]`           number of fields or items
+    //   `"`               offset in strings_, the next word is the length
+    //   `l` `u` `d`       the next word is the int64_t, uint64_t or double
+    //   `t` `f` `n`       nothing
+    std::vector<uint64_t> tape_;
+    std::string strings_;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
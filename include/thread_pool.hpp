@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Fixed set of worker threads for the parallel parsing functions. A pool
+// runs one job at a time, concurrent Run() calls wait for each other, so
+// give every ingest thread its own pool if they must not be serialized.
+class ThreadPool
+{
+public:
+    // NOTE: the calling thread takes part in every job, so a pool of size N
+    // starts N - 1 threads and a pool of size 1 runs everything inline
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t Size() const { return workers_.size() + 1; }
+
+    // Calls `task(0)` ... `task(count - 1)` spread over the pool and returns
+    // once all of them are done. The first exception thrown by a task is
+    // rethrown here after the remaining tasks are finished.
+    void Run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    void WorkerLoop();
+    void Work();
+
+private:
+    std::vector<std::thread> workers_;
+
+    std::mutex run_mutex_;          // one job at a time
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    // Current job, guarded by `mutex_` except for the index counter
+    const std::function<void(size_t)>* task_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_ = 0;
+    size_t busy_ = 0;
+    size_t generation_ = 0;
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "json.hpp"
+#include "key_interner.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+// Read-only tree whose strings and keys are views into the parsed text
+// instead of copies, see ParseInSitu. Containers take their memory from a
+// std::pmr::memory_resource.
+
+class ViewNode;
+
+namespace detail
+{
+class ViewBuilder;
+} // namespace detail
+
+// =============================================================================
+
+class ViewArray
+{
+public:
+    using Array = std::pmr::vector<ViewNode>;
+
+    explicit ViewArray(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : nodes_(resource) {}
+
+    size_t Size() const;
+
+    const ViewNode& At(size_t index) const;
+    const ViewNode& operator[](size_t index) const;
+
+    Array::const_iterator begin() const;
+    Array::const_iterator end() const;
+
+private:
+    friend class detail::ViewBuilder;
+
+    Array nodes_;
+};
+
+// =============================================================================
+
+// NOTE: fields are kept in input order and looked up by a linear scan, which
+// is faster than hashing for the small objects that make up most documents
+class ViewObject
+{
+public:
+    using Field = std::pair<std::string_view, ViewNode>;
+    using Fields = std::pmr::vector<Field>;
+
+    explicit ViewObject(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : fields_(resource) {}
+
+    bool Has(std::string_view field) const { return Find(field) != nullptr; }
+    const ViewNode& Get(std::string_view field) const;
+
+    const ViewNode& operator[](std::string_view field) const { return Get(field); }
+
+    // NOTE: compare pointers, so only keys of a tree parsed with the same
+    // JsonDeserializeOptions::key_interner are found
+    bool Has(InternedKey field) const { return Find(field) != nullptr; }
+    const ViewNode& Get(InternedKey field) const;
+
+    const ViewNode& operator[](InternedKey field) const { return Get(field); }
+
+    size_t Size() const;
+
+    Fields::const_iterator begin() const;
+    Fields::const_iterator end() const;
+
+private:
+    friend class detail::ViewBuilder;
+
+    const ViewNode* Find(std::string_view field) const;
+    const ViewNode* Find(InternedKey field) const;
+
+private:
+    Fields fields_;
+};
+
+// =============================================================================
+
+class ViewNode
+{
+public:
+    using Value = std::variant<
+        std::string_view,
+        JsonNumber,
+        JsonBool,
+        ViewObject,
+        ViewArray,
+        JsonNull
+    >;
+
+    template<typename T>
+    ViewNode(T&& t) :
+        value_(std::forward<T>(t))
+    {}
+
+    ViewNode() : value_(JsonNull()) {}
+
+    ViewNode(ViewNode&&) = default;
+    ViewNode(const ViewNode&) = delete;
+
+    ViewNode& operator=(ViewNode&&) = default;
+    ViewNode& operator=(const ViewNode&) = delete;
+
+    bool IsString() const { return value_.index() == 0; }
+    bool IsNumber() const { return value_.index() == 1; }
+    bool IsBool() const { return value_.index() == 2; }
+    bool IsObject() const { return value_.index() == 3; }
+    bool IsArray() const { return value_.index() == 4; }
+    bool IsNull() const { return value_.index() == 5; }
+
+    std::string_view AsString() const { return std::get<std::string_view>(value_); }
+    const JsonNumber& AsNumber() const { return std::get<JsonNumber>(value_); }
+    JsonBool AsBool() const { return std::get<JsonBool>(value_); }
+    const ViewObject& AsObject() const { return std::get<ViewObject>(value_); }
+    const ViewArray& AsArray() const { return std::get<ViewArray>(value_); }
+    JsonNull AsNull() const { return std::get<JsonNull>(value_); }
+
+    const Value& Get() const { return value_; }
+
+    // Deep copy into a regular, self-contained JsonNode
+    JsonNode Materialize() const;
+
+private:
+    friend class detail::ViewBuilder;
+
+    Value value_;
+};
+
+// =============================================================================
+
+// NOTE: defined here, where ViewNode is complete
+
+inline size_t ViewArray::Size() const { return nodes_.size(); }
+inline const ViewNode& ViewArray::operator[](size_t index) const { return nodes_[index]; }
+inline ViewArray::Array::const_iterator ViewArray::begin() const { return nodes_.begin(); }
+inline ViewArray::Array::const_iterator ViewArray::end() const { return nodes_.end(); }
+
+inline size_t ViewObject::Size() const { return fields_.size(); }
+inline ViewObject::Fields::const_iterator ViewObject::begin() const { return fields_.begin(); }
+inline ViewObject::Fields::const_iterator ViewObject::end() const { return fields_.end(); }
+
+// =============================================================================
+
+// Parses `buffer` in place: escape sequences are decoded inside the buffer
+// and every string and key of the result is a view into it, so parsing
+// allocates only for arrays and objects.
+//
+// Lifetime: the buffer is owned by the caller and must outlive the returned
+// ViewNode and everything taken from it, and must not be modified while they
+// are in use. The buffer no longer holds the original JSON afterwards (string
+// bodies get shorter when escapes are decoded); keep a copy if it is needed.
+//
+// NOTE: malformed input is reported at the same offset as by ParseFrom, but
+// its line and column are counted in the buffer as decoded so far, where a
+// `\n` escape in an earlier string has become a line break
+ViewNode ParseInSitu(std::span<char> buffer, const JsonDeserializeOptions& options = {});
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
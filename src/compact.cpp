@@ -0,0 +1,471 @@
+#include "compact.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "detail/reader.hpp"
+#include "exceptions.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// NOTE: nodes take about as much as the input for typical documents, the
+// arena grows geometrically past that
+constexpr size_t MIN_ARENA_SIZE = 1024;
+
+constexpr uint64_t POSITION_MASK = 0xFFFFFFFF;
+
+uint64_t HashKey(std::string_view key)
+{
+    return std::hash<std::string_view>{}(key);
+}
+
+} // namespace
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// Event handler that assembles a CompactNode tree. Values of open containers
+// wait on one stack, keys and values of objects alternating, and are copied
+// into a buffer of the exact size from the arena when their container ends.
+class CompactBuilder
+{
+public:
+    CompactBuilder(std::pmr::memory_resource* arena, KeyInterner* interner) :
+        arena_(arena),
+        interner_(interner)
+    {}
+
+    bool StartObject() { return Open(); }
+    bool StartArray() { return Open(); }
+
+    bool EndObject(size_t)
+    {
+        size_t start = starts_.back();
+        size_t count = (values_.size() - start) / 2;
+
+        // NOTE: the index, if any, shares the allocation of the fields
+        size_t capacity = CompactNode::IndexCapacity(count);
+        CheckSize(count);
+        CompactField* fields = nullptr;
+        if (count > 0)
+            fields = static_cast<CompactField*>(arena_->allocate(count * sizeof(CompactField) + capacity * sizeof(uint64_t), alignof(CompactField)));
+        for (size_t i = 0; i < count; i++)
+            new (fields + i) CompactField{values_[start + 2 * i], values_[start + 2 * i + 1]};
+
+        if (capacity > 0)
+            BuildIndex(fields, count, reinterpret_cast<uint64_t*>(fields + count), capacity);
+
+        CompactNode node;
+        node.Set(CompactNode::Type::Object, {.fields_ = fields}, static_cast<uint32_t>(count));
+        return Close(node);
+    }
+
+    bool EndArray(size_t)
+    {
+        size_t start = starts_.back();
+        size_t count = values_.size() - start;
+
+        CompactNode* nodes = Allocate<CompactNode>(count);
+        std::uninitialized_copy(values_.begin() + static_cast<ptrdiff_t>(start), values_.end(), nodes);
+
+        CompactNode node;
+        node.Set(CompactNode::Type::Array, {.nodes_ = nodes}, static_cast<uint32_t>(count));
+        return Close(node);
+    }
+
+    bool Key(std::string_view key)
+    {
+        if (!interner_)
+            return String(key);
+
+        // NOTE: out of line even when short, so that lookups by InternedKey
+        // can compare pointers
+        std::string_view interned = interner_->Intern(key).View();
+        CheckSize(interned.size());
+        CompactNode node;
+        node.Set(CompactNode::Type::String, {.chars_ = interned.data()}, static_cast<uint32_t>(interned.size()));
+        values_.push_back(node);
+        return true;
+    }
+
+    bool String(std::string_view str)
+    {
+        CompactNode node;
+        if (str.size() <= CompactNode::INLINE_SIZE)
+        {
+            node.type_ = CompactNode::Type::String;
+            std::memcpy(node.data_, str.data(), str.size());
+            node.inline_size_ = static_cast<uint8_t>(str.size());
+        }
+        else
+        {
+            char* chars = Allocate<char>(str.size());
+            std::memcpy(chars, str.data(), str.size());
+            node.Set(CompactNode::Type::String, {.chars_ = chars}, static_cast<uint32_t>(str.size()));
+        }
+        values_.push_back(node);
+        return true;
+    }
+
+    bool Number(const JsonNumber& number)
+    {
+        values_.emplace_back(number);
+        return true;
+    }
+
+    bool Bool(bool b)
+    {
+        values_.emplace_back(b);
+        return true;
+    }
+
+    bool Null()
+    {
+        values_.emplace_back(nullptr);
+        return true;
+    }
+
+    // Replays `node` as the events a parse of it would produce
+    void Add(const JsonNode& node)
+    {
+        if (node.IsString())
+            String(node.AsString());
+        else if (node.IsNumber())
+            Number(node.AsNumber());
+        else if (node.IsBool())
+            Bool(node.AsBool());
+        else if (node.IsNull())
+            Null();
+        else if (node.IsArray())
+        {
+            StartArray();
+            for (const JsonNode& item: node.AsArray())
+                Add(item);
+            EndArray(node.AsArray().Size());
+        }
+        else
+        {
+            StartObject();
+            for (const auto& [key, value]: node.AsObject())
+            {
+                Key(key);
+                Add(value);
+            }
+            EndObject(node.AsObject().Size());
+        }
+    }
+
+    CompactNode Result() const { return values_.back(); }
+
+private:
+    bool Open()
+    {
+        starts_.push_back(values_.size());
+        return true;
+    }
+
+    bool Close(CompactNode node)
+    {
+        values_.resize(starts_.back());
+        starts_.pop_back();
+        values_.push_back(node);
+        return true;
+    }
+
+    // NOTE: with linear probing the first of duplicate keys comes first on
+    // the probe sequence, so lookups keep finding the first one
+    static void BuildIndex(const CompactField* fields, size_t count, uint64_t* slots, size_t capacity)
+    {
+        std::fill(slots, slots + capacity, 0);
+        size_t mask = capacity - 1;
+        for (size_t position = 0; position < count; position++)
+        {
+            uint64_t hash = HashKey(fields[position].Key());
+            size_t i = hash & mask;
+            while (slots[i] != 0)
+                i = (i + 1) & mask;
+            slots[i] = (hash & ~POSITION_MASK) | (position + 1);
+        }
+    }
+
+    template<typename T>
+    T* Allocate(size_t count)
+    {
+        CheckSize(count);
+        if (count == 0)
+            return nullptr;
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    static void CheckSize(size_t size)
+    {
+        if (size > std::numeric_limits<uint32_t>::max())
+            throw JsonException("Too big for a CompactNode: {} items", size);
+    }
+
+private:
+    std::pmr::memory_resource* arena_;
+    KeyInterner* interner_;
+    std::vector<CompactNode> values_;
+    std::vector<size_t> starts_;
+};
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+CompactNode::CompactNode(bool b)
+{
+    Set(Type::Bool, {.bool_ = b});
+}
+
+// =============================================================================
+
+CompactNode::CompactNode(const JsonNumber& number)
+{
+    switch (number.GetType())
+    {
+    case JsonNumber::Type::Int64: Set(Type::Int64, {.int_ = number.To<int64_t>()}); break;
+    case JsonNumber::Type::UInt64: Set(Type::UInt64, {.uint_ = number.To<uint64_t>()}); break;
+    default: Set(Type::Double, {.double_ = number.To<double>()}); break;
+    }
+}
+
+// =============================================================================
+
+void CompactNode::Expect(Type type, const char* name) const
+{
+    if (type_ != type)
+        throw JsonException("Bad type: {} expected", name);
+}
+
+// =============================================================================
+
+void CompactNode::ExpectContainer() const
+{
+    if (!IsArray() && !IsObject())
+        throw JsonException("Bad type: array or object expected");
+}
+
+// =============================================================================
+
+JsonNull CompactNode::AsNull() const
+{
+    Expect(Type::Null, "null");
+    return nullptr;
+}
+
+// =============================================================================
+
+JsonBool CompactNode::AsBool() const
+{
+    Expect(Type::Bool, "bool");
+    return GetPayload().bool_;
+}
+
+// =============================================================================
+
+JsonNumber CompactNode::AsNumber() const
+{
+    switch (type_)
+    {
+    case Type::Int64: return JsonNumber{GetPayload().int_};
+    case Type::UInt64: return JsonNumber{GetPayload().uint_};
+    case Type::Double: return JsonNumber{GetPayload().double_};
+    default: throw JsonException("Bad type: number expected");
+    }
+}
+
+// =============================================================================
+
+std::string_view CompactNode::AsString() const
+{
+    Expect(Type::String, "string");
+    return Chars();
+}
+
+// =============================================================================
+
+std::span<const CompactNode> CompactNode::AsArray() const
+{
+    Expect(Type::Array, "array");
+    return {GetPayload().nodes_, GetSize()};
+}
+
+// =============================================================================
+
+std::span<const CompactField> CompactNode::AsObject() const
+{
+    Expect(Type::Object, "object");
+    return {GetPayload().fields_, GetSize()};
+}
+
+// =============================================================================
+
+size_t CompactNode::Size() const
+{
+    ExpectContainer();
+    return GetSize();
+}
+
+// =============================================================================
+
+const CompactNode& CompactNode::At(size_t index) const
+{
+    std::span<const CompactNode> nodes = AsArray();
+    if (index >= nodes.size())
+        throw JsonException("Out of bounds: index {} exceeds array size {}", index, nodes.size());
+    return nodes[index];
+}
+
+// =============================================================================
+
+size_t CompactNode::IndexCapacity(size_t count)
+{
+    return count > INDEX_THRESHOLD ? std::bit_ceil(count * 2) : 0;
+}
+
+// =============================================================================
+
+const CompactNode* CompactNode::Find(std::string_view field) const
+{
+    std::span<const CompactField> fields = AsObject();
+    size_t capacity = IndexCapacity(fields.size());
+    if (capacity == 0)
+    {
+        for (const CompactField& item: fields)
+        {
+            if (item.Key() == field)
+                return &item.Value();
+        }
+        return nullptr;
+    }
+
+    const uint64_t* slots = reinterpret_cast<const uint64_t*>(fields.data() + fields.size());
+    uint64_t hash = HashKey(field);
+    size_t mask = capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        uint64_t slot = slots[i];
+        if (slot == 0)
+            return nullptr;
+        if (slot >> 32 == hash >> 32)
+        {
+            const CompactField& item = fields[(slot & POSITION_MASK) - 1];
+            if (item.Key() == field)
+                return &item.Value();
+        }
+    }
+}
+
+// =============================================================================
+
+const CompactNode& CompactNode::Get(std::string_view field) const
+{
+    const CompactNode* node = Find(field);
+    if (!node)
+        throw JsonException("Unknown object field: `{}`", field);
+    return *node;
+}
+
+// =============================================================================
+
+const CompactNode* CompactNode::Find(InternedKey field) const
+{
+    for (const CompactField& item: AsObject())
+    {
+        const CompactNode& key = item.key_;
+        if (key.inline_size_ == OUT_OF_LINE && key.GetPayload().chars_ == field.Data())
+            return &item.value_;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+
+const CompactNode& CompactNode::Get(InternedKey field) const
+{
+    const CompactNode* node = Find(field);
+    if (!node)
+        throw JsonException("Unknown object field: `{}`", field.View());
+    return *node;
+}
+
+// =============================================================================
+
+JsonNode CompactNode::Materialize() const
+{
+    switch (type_)
+    {
+    case Type::Null: return JsonNode{nullptr};
+    case Type::Bool: return JsonNode{AsBool()};
+    case Type::String: return JsonNode{JsonString{AsString()}};
+    case Type::Array:
+    {
+        JsonArray array;
+        array.Reserve(GetSize());
+        for (const CompactNode& node: AsArray())
+            array.PushBack(node.Materialize());
+        return JsonNode{std::move(array)};
+    }
+    case Type::Object:
+    {
+        JsonObject object;
+        object.Reserve(GetSize());
+        for (const CompactField& field: AsObject())
+            object.AddField(std::string{field.Key()}, field.Value().Materialize());
+        return JsonNode{std::move(object)};
+    }
+    default: return JsonNode{AsNumber()};
+    }
+}
+
+// =============================================================================
+
+CompactDocument::CompactDocument(std::string_view str, const JsonDeserializeOptions& options) :
+    arena_(std::make_unique<std::pmr::monotonic_buffer_resource>(std::max(str.size(), MIN_ARENA_SIZE)))
+{
+    detail::CompactBuilder builder{arena_.get(), options.key_interner};
+    detail::ReadDocument(str, builder, options);
+    root_ = builder.Result();
+}
+
+// =============================================================================
+
+CompactDocument::CompactDocument() :
+    arena_(std::make_unique<std::pmr::monotonic_buffer_resource>(MIN_ARENA_SIZE))
+{}
+
+// =============================================================================
+
+CompactDocument Freeze(const JsonNode& node)
+{
+    CompactDocument document;
+    detail::CompactBuilder builder{document.arena_.get(), nullptr};
+    builder.Add(node);
+    document.root_ = builder.Result();
+    return document;
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
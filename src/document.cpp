@@ -0,0 +1,66 @@
+#include "document.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "detail/reader.hpp"
+#include "detail/view_builder.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// NOTE: the copy of the input takes its size, the nodes take about as much
+// again for typical documents; the arena grows geometrically past that
+constexpr size_t ARENA_SIZE_FACTOR = 2;
+constexpr size_t MIN_ARENA_SIZE = 1024;
+
+} // namespace
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+Document::Document(std::string_view str, const JsonDeserializeOptions& options) :
+    arena_(std::make_unique<std::pmr::monotonic_buffer_resource>(
+        std::max(str.size() * ARENA_SIZE_FACTOR, MIN_ARENA_SIZE)))
+{
+    char* buffer = static_cast<char*>(arena_->allocate(std::max<size_t>(str.size(), 1), 1));
+    std::memcpy(buffer, str.data(), str.size());
+
+    // NOTE: the error is described with `str`, strings decoded into the
+    // buffer before it may have shifted its line and column
+    detail::ViewBuilder builder{buffer, arena_.get(), options.key_interner};
+    std::vector<uint32_t> positions;
+    ParseError error;
+    if (!detail::TryReadDocument(std::string_view{buffer, str.size()}, builder, options, positions, error))
+        detail::ThrowParseError(str, detail::MakeParseError(str, error.code, error.offset), options);
+    root_ = std::move(builder.Result());
+}
+
+// =============================================================================
+
+// NOTE: polymorphic allocators do not move with a move assignment, so the
+// old tree is cleared first and the new one is move-constructed in its
+// place, taking its arena along
+Document& Document::operator=(Document&& other)
+{
+    if (this != &other)
+    {
+        root_ = ViewNode{};
+        root_ = std::move(other.root_);
+        arena_ = std::move(other.arena_);
+    }
+    return *this;
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
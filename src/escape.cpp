@@ -0,0 +1,228 @@
+#include "detail/escape.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include "detail/simd.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+constexpr size_t npos = std::string_view::npos;
+
+// =============================================================================
+
+// Value of the 4 hex digits at `pos`, or -1
+int32_t ParseHex4(std::string_view str, size_t pos)
+{
+    if (pos + 4 > str.size())
+        return -1;
+
+    int32_t value = 0;
+    for (size_t i = pos; i < pos + 4; i++)
+    {
+        char c = str[i];
+        int32_t digit;
+        if (c >= '0' && c <= '9')
+            digit = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            digit = c - 'A' + 10;
+        else
+            return -1;
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+// =============================================================================
+
+size_t WriteUtf8(uint32_t code_point, char* out)
+{
+    if (code_point < 0x80)
+    {
+        out[0] = static_cast<char>(code_point);
+        return 1;
+    }
+    if (code_point < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+        out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+        out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+    out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+// =============================================================================
+
+// Decodes the \u escape whose hex digits start at `pos`. Advances `pos` past
+// the escape (and past the low surrogate of a pair).
+size_t DecodeUnicode(std::string_view str, size_t& pos, char* out)
+{
+    int32_t code_point = ParseHex4(str, pos);
+    if (code_point < 0)
+        return npos;
+    pos += 4;
+
+    if (code_point >= 0xDC00 && code_point <= 0xDFFF)
+        return npos;
+
+    if (code_point >= 0xD800 && code_point <= 0xDBFF)
+    {
+        if (pos + 2 > str.size() || str[pos] != '\\' || str[pos + 1] != 'u')
+            return npos;
+
+        int32_t low = ParseHex4(str, pos + 2);
+        if (low < 0xDC00 || low > 0xDFFF)
+            return npos;
+        pos += 6;
+
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    return WriteUtf8(static_cast<uint32_t>(code_point), out);
+}
+
+// =============================================================================
+
+// `copy_run(pos, out)` moves the plain run starting at `pos` to `out` and
+// returns the position of the backslash that ends it
+template<typename CopyRun>
+size_t Decode(std::string_view str, char* out, CopyRun copy_run)
+{
+    size_t pos = 0;
+    size_t written = 0;
+    while (true)
+    {
+        size_t backslash = copy_run(pos, out + written);
+        written += backslash - pos;
+
+        if (backslash == str.size())
+            return written;
+        if (backslash + 1 == str.size())
+            return npos;
+
+        pos = backslash + 2;
+        switch (str[backslash + 1])
+        {
+        case '"': out[written++] = '"'; break;
+        case '\\': out[written++] = '\\'; break;
+        case '/': out[written++] = '/'; break;
+        case 'b': out[written++] = '\b'; break;
+        case 'f': out[written++] = '\f'; break;
+        case 'n': out[written++] = '\n'; break;
+        case 'r': out[written++] = '\r'; break;
+        case 't': out[written++] = '\t'; break;
+        case 'u':
+        {
+            size_t size = DecodeUnicode(str, pos, out + written);
+            if (size == npos)
+                return npos;
+            written += size;
+            break;
+        }
+        default:
+            return npos;
+        }
+    }
+}
+
+// =============================================================================
+
+// Bytes that must be escaped in JSON output: `"`, `\` and control characters
+constexpr std::array<bool, 256> NEEDS_ESCAPE = [] {
+    std::array<bool, 256> table{};
+    for (size_t c = 0; c < 0x20; c++)
+        table[c] = true;
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+}();
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+size_t DecodeEscapes(std::string_view str, char* out)
+{
+    // NOTE: plain runs are moved as a whole, nothing is moved before the
+    // first escape
+    return Decode(str, out, [&](size_t pos, char* run_out) {
+        const void* found = std::memchr(str.data() + pos, '\\', str.size() - pos);
+        size_t backslash = found ? static_cast<const char*>(found) - str.data() : str.size();
+        if (run_out != str.data() + pos)
+            std::memmove(run_out, str.data() + pos, backslash - pos);
+        return backslash;
+    });
+}
+
+// =============================================================================
+
+size_t DecodeEscapesCopy(std::string_view str, char* out)
+{
+    return Decode(str, out, [&](size_t pos, char* run_out) { return CopyUntilBackslash(str, pos, run_out); });
+}
+
+// =============================================================================
+
+void WriteEscaped(std::ostream& stream, std::string_view str)
+{
+    static constexpr char HEX[] = "0123456789abcdef";
+
+    size_t run = 0;
+    for (size_t pos = 0; pos < str.size(); pos++)
+    {
+        unsigned char c = static_cast<unsigned char>(str[pos]);
+        if (!NEEDS_ESCAPE[c])
+            continue;
+
+        stream.write(str.data() + run, pos - run);
+        run = pos + 1;
+        switch (c)
+        {
+        case '"': stream.write("\\\"", 2); break;
+        case '\\': stream.write("\\\\", 2); break;
+        case '\b': stream.write("\\b", 2); break;
+        case '\f': stream.write("\\f", 2); break;
+        case '\n': stream.write("\\n", 2); break;
+        case '\r': stream.write("\\r", 2); break;
+        case '\t': stream.write("\\t", 2); break;
+        default:
+        {
+            char escape[] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+            stream.write(escape, sizeof(escape));
+            break;
+        }
+        }
+    }
+    stream.write(str.data() + run, str.size() - run);
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -1,10 +1,29 @@
 #include "json.hpp"
 
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "detail/number.hpp"
 #include "exceptions.hpp"
 #include "serialize_visitor.hpp"
 
 // =============================================================================
 
+namespace
+{
+
+constexpr uint64_t POSITION_MASK = 0xFFFFFFFF;
+
+uint64_t HashKey(std::string_view key)
+{
+    return std::hash<std::string_view>{}(key);
+}
+
+} // namespace
+
+// =============================================================================
+
 namespace mj
 {
 
@@ -17,6 +36,41 @@ void JsonNode::SerializeToStream(std::ostream& stream, JsonSerializeOptions opti
 
 // =============================================================================
 
+NumberTagged NumberTagged::FromRaw(std::string_view text)
+{
+    NumberTagged number;
+    number.pending_ = true;
+    number.CopyRaw(text);
+    return number;
+}
+
+// =============================================================================
+
+void NumberTagged::CopyRaw(std::string_view text)
+{
+    raw_size_ = static_cast<uint32_t>(text.size());
+    char* data = raw_.inline_;
+    if (!IsInline())
+        data = raw_.heap_ = new char[text.size()];
+    std::memcpy(data, text.data(), text.size());
+}
+
+// =============================================================================
+
+void NumberTagged::Convert() const
+{
+    std::string_view text = RawText();
+    NumberTagged number{0};
+    if (detail::ParseNumberExact(text.data(), text.data() + text.size(), number) != text.data() + text.size())
+        throw JsonException("Bad number: `{}`", text);
+
+    type_ = number.type_;
+    value_ = number.value_;
+    pending_ = false;
+}
+
+// =============================================================================
+
 void JsonArray::Reserve(size_t capacity)
 {
     nodes_.reserve(capacity);
@@ -62,32 +116,101 @@ void JsonArray::CheckBounds(size_t index) const
 
 // =============================================================================
 
-bool JsonObject::Has(const std::string &field)
+JsonNode& JsonObject::Get(std::string_view field)
 {
-    return map_.contains(field);
+    return const_cast<JsonNode&>(std::as_const(*this).Get(field));
 }
 
 // =============================================================================
 
-JsonNode& JsonObject::Get(const std::string &field)
+const JsonNode& JsonObject::Get(std::string_view field) const
 {
-    if (!Has(field))
+    const JsonNode* node = Find(field);
+    if (!node)
         throw mj::JsonException("Unknown object field: `{}`", field);
-    return map_.find(field)->second;
+    return *node;
 }
 
 // =============================================================================
 
-const JsonNode& JsonObject::Get(const std::string &field) const
+void JsonObject::Reserve(size_t capacity)
 {
-    return map_.find(field)->second;
+    fields_.reserve(capacity);
 }
 
 // =============================================================================
 
 size_t JsonObject::Size() const
 {
-    return map_.size();
+    return fields_.size();
+}
+
+// =============================================================================
+
+const JsonNode* JsonObject::Find(std::string_view field, uint64_t* hash) const
+{
+    if (slots_.empty())
+    {
+        for (const Field& item: fields_)
+        {
+            if (item.first == field)
+                return &item.second;
+        }
+        return nullptr;
+    }
+
+    uint64_t field_hash = HashKey(field);
+    if (hash)
+        *hash = field_hash;
+
+    size_t mask = slots_.size() - 1;
+    for (size_t i = field_hash & mask;; i = (i + 1) & mask)
+    {
+        uint64_t slot = slots_[i];
+        if (slot == 0)
+            return nullptr;
+        if (slot >> 32 == field_hash >> 32)
+        {
+            const Field& item = fields_[(slot & POSITION_MASK) - 1];
+            if (item.first == field)
+                return &item.second;
+        }
+    }
+}
+
+// =============================================================================
+
+// NOTE: an index that exists already existed when AddField looked the key
+// up, so `hash` is set whenever it is inserted here
+void JsonObject::Index(size_t position, uint64_t hash)
+{
+    if (fields_.size() <= INDEX_THRESHOLD)
+        return;
+
+    if (fields_.size() * 2 > slots_.size())
+        Rehash(std::bit_ceil(fields_.size() * 4));
+    else
+        Insert(hash, position);
+}
+
+// =============================================================================
+
+void JsonObject::Rehash(size_t capacity)
+{
+    slots_.assign(capacity, 0);
+    for (size_t i = 0; i < fields_.size(); i++)
+        Insert(HashKey(fields_[i].first), i);
+}
+
+// =============================================================================
+
+void JsonObject::Insert(uint64_t hash, size_t position)
+{
+    size_t mask = slots_.size() - 1;
+    size_t i = hash & mask;
+    while (slots_[i] != 0)
+        i = (i + 1) & mask;
+    slots_[i] = (hash & ~POSITION_MASK) | (position + 1);
 }
 
 // =============================================================================
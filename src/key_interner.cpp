@@ -0,0 +1,47 @@
+#include "key_interner.hpp"
+
+#include <mutex>
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+InternedKey KeyInterner::Intern(std::string_view key)
+{
+    size_t hash = Hash{}(key);
+    Shard& shard = shards_[hash % SHARD_COUNT];
+
+    {
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.keys.find(key);
+        if (it != shard.keys.end())
+            return InternedKey{*it};
+    }
+
+    // NOTE: another thread may have added the key in between, emplace finds it
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.keys.emplace(key).first;
+    return InternedKey{*it};
+}
+
+// =============================================================================
+
+size_t KeyInterner::Size() const
+{
+    size_t size = 0;
+    for (const Shard& shard: shards_)
+    {
+        std::shared_lock lock(shard.mutex);
+        size += shard.keys.size();
+    }
+    return size;
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
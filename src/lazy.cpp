@@ -0,0 +1,415 @@
+#include "lazy.hpp"
+
+#include <cstring>
+
+#include "detail/escape.hpp"
+#include "detail/number.hpp"
+#include "detail/simd.hpp"
+#include "parser.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Position of the first byte after the string opened at `pos`
+size_t SkipString(std::string_view str, size_t pos)
+{
+    size_t idx = mj::detail::FindQuoteOrBackslash(str, pos + 1);
+    while (idx < str.size() && str[idx] != '"')
+        idx = mj::detail::FindQuoteOrBackslash(str, idx + 2);
+
+    if (idx >= str.size())
+        throw mj::JsonException("Bad JSON: unterminated string at offset {}", pos);
+    return idx + 1;
+}
+
+// =============================================================================
+
+bool IsDelimiter(char c)
+{
+    return c == ',' || c == ']' || c == '}' || c == ':' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// =============================================================================
+
+// Position of the first byte after the value at `pos`. Only brackets and
+// strings are looked at, skipped values are not validated.
+size_t SkipValue(std::string_view str, size_t pos)
+{
+    if (pos >= str.size())
+        throw mj::JsonException("Bad JSON: value expected at offset {}", pos);
+
+    if (str[pos] == '"')
+        return SkipString(str, pos);
+
+    if (str[pos] != '[' && str[pos] != '{')
+    {
+        size_t end = pos;
+        while (end < str.size() && !IsDelimiter(str[end]))
+            end++;
+        return end;
+    }
+
+    size_t depth = 0;
+    for (size_t idx = pos; idx < str.size();)
+    {
+        switch (str[idx])
+        {
+        case '"':
+            idx = SkipString(str, idx);
+            continue;
+        case '[': case '{':
+            depth++;
+            break;
+        case ']': case '}':
+            if (--depth == 0)
+                return idx + 1;
+            break;
+        default:
+            break;
+        }
+        idx++;
+    }
+    throw mj::JsonException("Bad JSON: unterminated container at offset {}", pos);
+}
+
+// =============================================================================
+
+size_t SkipWhitespaces(std::string_view str, size_t pos)
+{
+    return mj::detail::SkipWhitespaces(str, pos);
+}
+
+// =============================================================================
+
+// Moves past the `,` separating container items, or stays at the closing bracket
+size_t NextItem(std::string_view str, size_t pos, char close)
+{
+    pos = SkipWhitespaces(str, pos);
+    if (pos < str.size() && str[pos] == ',')
+    {
+        pos = SkipWhitespaces(str, pos + 1);
+        if (pos < str.size() && str[pos] != close)
+            return pos;
+    }
+    else if (pos < str.size() && str[pos] == close)
+        return pos;
+    throw mj::JsonException("Bad JSON: expected `,` or `{}` at offset {}", close, pos);
+}
+
+// =============================================================================
+
+// Parses the object field at `pos`, returns false at the closing `}`
+bool ReadField(std::string_view str, size_t pos, std::string_view& key, size_t& value_pos)
+{
+    if (pos < str.size() && str[pos] == '}')
+        return false;
+    if (pos >= str.size() || str[pos] != '"')
+        throw mj::JsonException("Bad JSON: object key expected at offset {}", pos);
+
+    size_t key_end = SkipString(str, pos);
+    key = str.substr(pos + 1, key_end - pos - 2);
+
+    size_t colon = SkipWhitespaces(str, key_end);
+    if (colon >= str.size() || str[colon] != ':')
+        throw mj::JsonException("Bad JSON: expected `:` at offset {}", colon);
+
+    value_pos = SkipWhitespaces(str, colon + 1);
+    return true;
+}
+
+// =============================================================================
+
+// The key with its escapes decoded into `buffer`, or the key itself if it
+// has none
+std::string_view DecodeKey(std::string_view key, std::string& buffer)
+{
+    if (std::memchr(key.data(), '\\', key.size()) == nullptr)
+        return key;
+
+    buffer.resize(key.size());
+    size_t size = mj::detail::DecodeEscapesCopy(key, buffer.data());
+    if (size == std::string_view::npos)
+        throw mj::JsonException("Bad JSON: invalid escape sequence in `{}`", key.substr(0, 64));
+    buffer.resize(size);
+    return buffer;
+}
+
+// =============================================================================
+
+template<typename Parse>
+auto ParseScalar(Parse parse, std::string_view str, size_t pos, const mj::JsonDeserializeOptions& options,
+                 bool (mj::JsonNode::*check)() const, const char* type)
+{
+    auto [node, tail] = parse(str.substr(pos), options);
+    if (!(node.*check)() || (!tail.empty() && tail.front() != ',' && tail.front() != ']' && tail.front() != '}'))
+        throw mj::JsonException("Bad JSON: {} expected at offset {}", type, pos);
+    return std::move(node);
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+LazyDocument::LazyDocument(std::string_view str, const JsonDeserializeOptions& options) :
+    str_(str),
+    options_(options),
+    root_(::SkipWhitespaces(str, 0))
+{
+    if (root_ == str_.size())
+        throw JsonException("Bad JSON: empty input");
+}
+
+// =============================================================================
+
+char LazyValue::Peek() const
+{
+    return pos_ < doc_->str_.size() ? doc_->str_[pos_] : '\0';
+}
+
+// =============================================================================
+
+// NOTE: NaN and Infinity count as numbers outside of strict mode, as in the parser
+bool LazyValue::IsNumber() const
+{
+    char c = Peek();
+    return c == '-' || detail::IsDigit(c) || (!doc_->options_.strict && (c == 'N' || c == 'I'));
+}
+
+// =============================================================================
+
+JsonString LazyValue::AsString() const
+{
+    JsonNode node = ParseScalar(ParseString, doc_->str_, pos_, doc_->options_, &JsonNode::IsString, "string");
+    return std::move(node.AsString());
+}
+
+// =============================================================================
+
+JsonNumber LazyValue::AsNumber() const
+{
+    JsonNode node = ParseScalar(ParseNumber, doc_->str_, pos_, doc_->options_, &JsonNode::IsNumber, "number");
+    return std::move(node.AsNumber());
+}
+
+// =============================================================================
+
+JsonBool LazyValue::AsBool() const
+{
+    return ParseScalar(ParseBool, doc_->str_, pos_, doc_->options_, &JsonNode::IsBool, "bool").AsBool();
+}
+
+// =============================================================================
+
+JsonNull LazyValue::AsNull() const
+{
+    std::string_view str = doc_->str_;
+    if (!str.substr(pos_).starts_with("null") || (pos_ + 4 < str.size() && !IsDelimiter(str[pos_ + 4])))
+        throw JsonException("Bad JSON: null expected at offset {}", pos_);
+    return nullptr;
+}
+
+// =============================================================================
+
+LazyObject LazyValue::AsObject() const
+{
+    if (!IsObject())
+        throw JsonException("Bad JSON: object expected at offset {}", pos_);
+    return LazyObject{doc_, ::SkipWhitespaces(doc_->str_, pos_ + 1)};
+}
+
+// =============================================================================
+
+LazyArray LazyValue::AsArray() const
+{
+    if (!IsArray())
+        throw JsonException("Bad JSON: array expected at offset {}", pos_);
+    return LazyArray{doc_, ::SkipWhitespaces(doc_->str_, pos_ + 1)};
+}
+
+// =============================================================================
+
+JsonNode LazyValue::Materialize() const
+{
+    return ParseFrom(Raw(), doc_->options_);
+}
+
+// =============================================================================
+
+std::string_view LazyValue::Raw() const
+{
+    return doc_->str_.substr(pos_, SkipValue(doc_->str_, pos_) - pos_);
+}
+
+// =============================================================================
+
+LazyObject::Iterator::Iterator(const LazyDocument* doc, size_t pos) :
+    doc_(doc),
+    pos_(pos),
+    field_({}, LazyValue{doc, pos})
+{
+    std::string_view key;
+    size_t value_pos;
+    if (pos_ != std::string_view::npos && ReadField(doc_->str_, pos_, key, value_pos))
+        field_ = {DecodeKey(key, decoded_), LazyValue{doc_, value_pos}};
+}
+
+// =============================================================================
+
+LazyObject::Iterator::Iterator(const Iterator& other) :
+    doc_(other.doc_),
+    pos_(other.pos_),
+    decoded_(other.decoded_),
+    field_(other.field_)
+{
+    if (other.field_.first.data() == other.decoded_.data())
+        field_.first = decoded_;
+}
+
+// =============================================================================
+
+LazyObject::Iterator& LazyObject::Iterator::operator=(const Iterator& other)
+{
+    doc_ = other.doc_;
+    pos_ = other.pos_;
+    decoded_ = other.decoded_;
+    field_ = other.field_;
+    if (other.field_.first.data() == other.decoded_.data())
+        field_.first = decoded_;
+    return *this;
+}
+
+// =============================================================================
+
+bool LazyObject::Iterator::AtEnd() const
+{
+    return pos_ == std::string_view::npos || (pos_ < doc_->str_.size() && doc_->str_[pos_] == '}');
+}
+
+// =============================================================================
+
+LazyObject::Iterator& LazyObject::Iterator::operator++()
+{
+    *this = Iterator{doc_, NextItem(doc_->str_, SkipValue(doc_->str_, field_.second.pos_), '}')};
+    return *this;
+}
+
+// =============================================================================
+
+// NOTE: keys with escapes are decoded before the comparison, the others are
+// compared as they are in the input
+bool LazyObject::Find(std::string_view field, size_t& value_pos) const
+{
+    std::string_view key;
+    std::string decoded;
+    for (size_t pos = pos_; ReadField(doc_->str_, pos, key, value_pos);)
+    {
+        if (DecodeKey(key, decoded) == field)
+            return true;
+        pos = NextItem(doc_->str_, SkipValue(doc_->str_, value_pos), '}');
+    }
+    return false;
+}
+
+// =============================================================================
+
+bool LazyObject::Has(std::string_view field) const
+{
+    size_t value_pos;
+    return Find(field, value_pos);
+}
+
+// =============================================================================
+
+LazyValue LazyObject::Get(std::string_view field) const
+{
+    size_t value_pos;
+    if (!Find(field, value_pos))
+        throw mj::JsonException("Unknown object field: `{}`", field);
+    return LazyValue{doc_, value_pos};
+}
+
+// =============================================================================
+
+size_t LazyObject::Size() const
+{
+    std::string_view key;
+    size_t value_pos;
+    size_t size = 0;
+    for (size_t pos = pos_; ReadField(doc_->str_, pos, key, value_pos); size++)
+        pos = NextItem(doc_->str_, SkipValue(doc_->str_, value_pos), '}');
+    return size;
+}
+
+// =============================================================================
+
+LazyObject::Iterator LazyObject::begin() const
+{
+    return Iterator{doc_, pos_};
+}
+
+// =============================================================================
+
+LazyObject::Iterator LazyObject::end() const
+{
+    return Iterator{doc_, std::string_view::npos};
+}
+
+// =============================================================================
+
+LazyArray::Iterator& LazyArray::Iterator::operator++()
+{
+    value_.pos_ = NextItem(value_.doc_->str_, SkipValue(value_.doc_->str_, value_.pos_), ']');
+    return *this;
+}
+
+// =============================================================================
+
+LazyValue LazyArray::At(size_t index) const
+{
+    size_t i = 0;
+    for (auto it = begin(); it != end(); ++it, ++i)
+    {
+        if (i == index)
+            return *it;
+    }
+    throw JsonException("Out of bounds: index {} exceeds array size {}", index, i);
+}
+
+// =============================================================================
+
+size_t LazyArray::Size() const
+{
+    size_t size = 0;
+    for (auto it = begin(); it != end(); ++it)
+        size++;
+    return size;
+}
+
+// =============================================================================
+
+LazyArray::Iterator LazyArray::begin() const
+{
+    return Iterator{doc_, pos_};
+}
+
+// =============================================================================
+
+LazyArray::Iterator LazyArray::end() const
+{
+    return Iterator{doc_, std::string_view::npos};
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,115 @@
+#include "detail/mapped_file.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exceptions.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Closes the descriptor on every way out of the constructor, the mapping
+// stays valid without it
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd) : fd_(fd) {}
+    ~FileDescriptor() { if (fd_ >= 0) ::close(fd_); }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int Get() const { return fd_; }
+
+private:
+    int fd_;
+};
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    FileDescriptor fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd.Get() < 0)
+        throw JsonException("Can not open `{}`: {}", path.string(), std::strerror(errno));
+
+    struct stat info;
+    if (::fstat(fd.Get(), &info) != 0)
+        throw JsonException("Can not stat `{}`: {}", path.string(), std::strerror(errno));
+
+    if (!S_ISREG(info.st_mode))
+    {
+        Read(fd.Get(), path);
+        return;
+    }
+
+    // NOTE: mmap refuses empty mappings, an empty view does the same job
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0)
+        return;
+
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.Get(), 0);
+    if (data_ == MAP_FAILED)
+    {
+        data_ = nullptr;
+        throw JsonException("Can not map `{}`: {}", path.string(), std::strerror(errno));
+    }
+
+    // Both stages walk the input front to back once: let the kernel read ahead
+    // aggressively and drop pages behind, and back the mapping with huge pages
+    // where the page cache supports them. These are hints, failures are fine.
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(data_, size_, MADV_HUGEPAGE);
+#endif
+}
+
+// =============================================================================
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(data_, size_);
+}
+
+// =============================================================================
+
+void MappedFile::Read(int fd, const std::filesystem::path& path)
+{
+    char chunk[64 * 1024];
+    while (true)
+    {
+        ssize_t count = ::read(fd, chunk, sizeof(chunk));
+        if (count == 0)
+            return;
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw JsonException("Can not read `{}`: {}", path.string(), std::strerror(errno));
+        }
+        buffer_.append(chunk, static_cast<size_t>(count));
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
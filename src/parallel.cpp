@@ -0,0 +1,377 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+
+#include "detail/dom_builder.hpp"
+#include "detail/reader.hpp"
+#include "parser.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// NOTE: several chunks per thread keep the threads busy when records differ in
+// size, the lower bound keeps the per-chunk overhead small
+constexpr size_t CHUNKS_PER_THREAD = 8;
+constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+constexpr std::string_view JSON_EXCEPTION_PREFIX = "[JSON] ";
+
+// NOTE: below this size the split and stitch overhead outweighs the gain
+constexpr size_t MIN_PARALLEL_ARRAY_SIZE = 1024 * 1024;
+constexpr size_t SLICES_PER_THREAD = 4;
+
+// =============================================================================
+
+struct Chunk
+{
+    std::string_view str;
+    std::vector<mj::JsonNode> nodes;
+
+    // Line within the chunk that failed to parse, and why
+    size_t error_line = 0;
+    std::exception_ptr error;
+};
+
+// =============================================================================
+
+// Cuts `str` into pieces of about `chunk_size` bytes, every piece ends right
+// after a newline or at the end of the input
+std::vector<Chunk> SplitLines(std::string_view str, size_t chunk_size)
+{
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+    while (begin < str.size())
+    {
+        size_t end = str.size();
+        if (str.size() - begin > chunk_size)
+        {
+            size_t newline = str.find('\n', begin + chunk_size);
+            if (newline != std::string_view::npos)
+                end = newline + 1;
+        }
+
+        chunks.emplace_back().str = str.substr(begin, end - begin);
+        begin = end;
+    }
+    return chunks;
+}
+
+// =============================================================================
+
+void ParseChunk(Chunk& chunk, const mj::JsonDeserializeOptions& options)
+{
+    // NOTE: records are small, so the structural index buffer is shared by
+    // all of them instead of being allocated by ParseFrom for each one
+    std::vector<uint32_t> positions;
+
+    std::string_view str = chunk.str;
+    for (size_t line = 0; !str.empty(); line++)
+    {
+        size_t newline = std::min(str.find('\n'), str.size());
+        std::string_view record = str.substr(0, newline);
+        str.remove_prefix(std::min(newline + 1, str.size()));
+
+        if (std::all_of(record.begin(), record.end(), [](char c) { return c == ' ' || c == '\t' || c == '\r'; }))
+            continue;
+
+        try
+        {
+            mj::detail::DomBuilder builder;
+            mj::detail::ReadDocument(record, builder, options, positions);
+            chunk.nodes.push_back(std::move(builder.Result()));
+        }
+        catch (const mj::JsonException&)
+        {
+            chunk.error_line = line;
+            chunk.error = std::current_exception();
+            return;
+        }
+    }
+}
+
+// =============================================================================
+
+[[noreturn]] void ThrowWithLine(std::string_view str, const Chunk& chunk)
+{
+    size_t lines_before = std::count(str.data(), chunk.str.data(), '\n');
+    try
+    {
+        std::rethrow_exception(chunk.error);
+    }
+    catch (const mj::JsonException& e)
+    {
+        std::string_view reason = e.what();
+        if (reason.starts_with(JSON_EXCEPTION_PREFIX))
+            reason.remove_prefix(JSON_EXCEPTION_PREFIX.size());
+        throw mj::JsonException("{} (line {})", reason, lines_before + chunk.error_line + 1);
+    }
+}
+
+// =============================================================================
+
+mj::ThreadPool& DefaultPool()
+{
+    static mj::ThreadPool pool;
+    return pool;
+}
+
+// =============================================================================
+
+// Run of elements of the top-level array, parsed on its own
+struct Slice
+{
+    size_t begin;       // first byte after the `[` or `,` in front of the slice
+    size_t end;         // position of the `,` or `]` after it
+    std::vector<mj::JsonNode> nodes;
+    bool parsed = false;
+};
+
+// =============================================================================
+
+// Guess for a top-level comma in [from, limit): elements of big arrays mostly
+// share one type and, for objects, the first key, so the best guess is a comma
+// followed by the same bytes as the first element (`pattern`), then a comma
+// followed by at least the same first byte. Guesses are checked later, see
+// ParseArrayParallel.
+size_t FindSplit(std::string_view str, size_t from, size_t limit, std::string_view pattern)
+{
+    size_t fallback = std::string_view::npos;
+    for (size_t pos = str.find(',', from); pos < limit; pos = str.find(',', pos + 1))
+    {
+        size_t next = mj::detail::SkipWhitespaces(str, pos + 1);
+        if (str.substr(next).starts_with(pattern))
+            return pos;
+        if (fallback == std::string_view::npos && next < limit && str[next] == pattern.front())
+            fallback = pos;
+    }
+    return fallback;
+}
+
+// =============================================================================
+
+// Start of the first element up to the end of its first key for objects, the
+// first byte otherwise
+std::string_view SplitPattern(std::string_view str, size_t first)
+{
+    static constexpr size_t MAX_PATTERN_SIZE = 32;
+
+    if (str[first] != '{')
+        return str.substr(first, 1);
+
+    size_t key = mj::detail::SkipWhitespaces(str, first + 1);
+    size_t key_end = (key < str.size() && str[key] == '"') ? str.find('"', key + 1) : std::string_view::npos;
+    if (key_end == std::string_view::npos || key_end - first >= MAX_PATTERN_SIZE)
+        return str.substr(first, 1);
+    return str.substr(first, key_end + 1 - first);
+}
+
+// =============================================================================
+
+// Parses the slice as `value, value, ...` assuming it starts at an element
+// boundary. Never throws on malformed input: the assumption may be wrong.
+void ParseSlice(std::string_view str, Slice& slice, const mj::JsonDeserializeOptions& options)
+{
+    std::string_view body = str.substr(slice.begin, slice.end - slice.begin);
+    if (body.size() > mj::detail::MAX_INDEXED_SIZE)
+        return;
+
+    std::vector<uint32_t> positions;
+    if (!mj::detail::BuildStructuralIndex(body, positions))
+        return;
+
+    mj::detail::IndexedCursor cursor{body, positions};
+    mj::detail::DomBuilder builder;
+    mj::detail::Reader<mj::detail::IndexedCursor, mj::detail::DomBuilder> reader{cursor, builder, options};
+
+    cursor.SkipWhitespaces();
+    do
+    {
+        if (!reader.ParseValue())
+            return;
+        slice.nodes.push_back(std::move(builder.Result()));
+    }
+    while (cursor.Consume(','));
+
+    slice.parsed = cursor.AtEnd();
+}
+
+// =============================================================================
+
+// Parses elements one by one from the start of `slices[index]`, which is known
+// to be an element boundary, until a comma turns out to open a later parsed
+// slice. Returns the index of that slice, or the number of slices once the
+// whole array is done.
+size_t ParseSequentially(std::string_view str, const std::vector<Slice>& slices, size_t index, mj::JsonArray& array,
+                         const mj::JsonDeserializeOptions& options)
+{
+    mj::detail::ScanCursor cursor{str.substr(0, slices.back().end)};
+    mj::detail::DomBuilder builder;
+    mj::detail::Reader<mj::detail::ScanCursor, mj::detail::DomBuilder> reader{cursor, builder, options};
+
+    cursor.Advance(slices[index].begin);
+    cursor.SkipWhitespaces();
+
+    size_t next = index + 1;
+    while (true)
+    {
+        if (!reader.ParseValue())
+            break;
+        array.PushBack(std::move(builder.Result()));
+
+        if (cursor.AtEnd())
+            return slices.size();
+
+        size_t comma = cursor.Position();
+        if (!cursor.Consume(','))
+            break;
+
+        while (next < slices.size() && slices[next].begin <= comma)
+            next++;
+        if (next < slices.size() && slices[next].begin == comma + 1 && slices[next].parsed)
+            return next;
+    }
+
+    // NOTE: the reader stops at the closing `]` of the array, which it does
+    // not see, so running out of input there is the character ParseFrom
+    // would complain about
+    mj::ParseErrorCode code = mj::ParseErrorCode::UnexpectedCharacter;
+    size_t position = cursor.Position();
+    if (reader.Error() != mj::ParseErrorCode::None)
+    {
+        code = reader.Error();
+        position = reader.ErrorPosition();
+    }
+    if (code == mj::ParseErrorCode::UnexpectedEnd && position < str.size())
+        code = mj::ParseErrorCode::UnexpectedCharacter;
+
+    // The top-level array itself is one more level than the elements see
+    mj::JsonDeserializeOptions array_options = options;
+    array_options.max_depth++;
+    mj::detail::ThrowParseError(str, mj::detail::MakeParseError(str, code, position), array_options);
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+std::vector<JsonNode> ParseNdjson(std::string_view str, ThreadPool& pool, const JsonDeserializeOptions& options)
+{
+    size_t chunk_size = std::max(str.size() / (pool.Size() * CHUNKS_PER_THREAD), MIN_CHUNK_SIZE);
+    std::vector<Chunk> chunks = SplitLines(str, chunk_size);
+
+    pool.Run(chunks.size(), [&](size_t index) { ParseChunk(chunks[index], options); });
+
+    size_t total = 0;
+    for (Chunk& chunk: chunks)
+    {
+        if (chunk.error)
+            ThrowWithLine(str, chunk);
+        total += chunk.nodes.size();
+    }
+
+    std::vector<JsonNode> result;
+    result.reserve(total);
+    for (Chunk& chunk: chunks)
+        std::move(chunk.nodes.begin(), chunk.nodes.end(), std::back_inserter(result));
+    return result;
+}
+
+// =============================================================================
+
+std::vector<JsonNode> ParseNdjson(std::string_view str, const JsonDeserializeOptions& options)
+{
+    return ParseNdjson(str, DefaultPool(), options);
+}
+
+// =============================================================================
+
+// Correctness does not depend on the guessed splits. The first slice starts
+// right after `[`, so it is parsed correctly. A slice that parses completely
+// ends with a whole element right before its closing comma. That proves that
+// comma is a top-level one, and so the next slice starts at an element
+// boundary too. When the chain breaks, the elements are parsed sequentially
+// from the last boundary that is known to be good.
+JsonNode ParseArrayParallel(std::string_view str, ThreadPool& pool, const JsonDeserializeOptions& options)
+{
+    std::string_view stripped = detail::StripWhitespaces(str);
+    if (stripped.size() < MIN_PARALLEL_ARRAY_SIZE || pool.Size() == 1 || options.max_depth == 0 ||
+        stripped.front() != '[' || stripped.back() != ']')
+    {
+        return ParseFrom(str, options);
+    }
+
+    size_t open = stripped.data() - str.data();
+    size_t close = open + stripped.size() - 1;
+    size_t first = detail::SkipWhitespaces(str, open + 1);
+    if (str[first] == ']')
+        return ParseFrom(str, options);
+    std::string_view pattern = SplitPattern(str, first);
+
+    // Evenly spaced guesses, every slice gets at least one byte
+    size_t count = pool.Size() * SLICES_PER_THREAD;
+    size_t step = (close - open) / count;
+
+    std::vector<Slice> slices;
+    size_t begin = open + 1;
+    for (size_t k = 1; k < count; k++)
+    {
+        size_t from = std::max(open + k * step, begin);
+        size_t split = FindSplit(str, from, std::min(from + step, close), pattern);
+        if (split == std::string_view::npos)
+            break;
+        slices.push_back(Slice{.begin = begin, .end = split, .nodes = {}});
+        begin = split + 1;
+    }
+    slices.push_back(Slice{.begin = begin, .end = close, .nodes = {}});
+
+    // NOTE: the top-level array itself is one level of nesting
+    JsonDeserializeOptions element_options = options;
+    element_options.max_depth--;
+
+    pool.Run(slices.size(), [&](size_t index) { ParseSlice(str, slices[index], element_options); });
+
+    JsonArray array;
+    size_t total = 0;
+    for (const Slice& slice: slices)
+        total += slice.nodes.size();
+    array.Reserve(total);
+
+    for (size_t index = 0; index < slices.size();)
+    {
+        if (!slices[index].parsed)
+        {
+            index = ParseSequentially(str, slices, index, array, element_options);
+            continue;
+        }
+
+        for (JsonNode& node: slices[index].nodes)
+            array.PushBack(std::move(node));
+        index++;
+    }
+
+    return JsonNode{std::move(array)};
+}
+
+// =============================================================================
+
+JsonNode ParseArrayParallel(std::string_view str, const JsonDeserializeOptions& options)
+{
+    return ParseArrayParallel(str, DefaultPool(), options);
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
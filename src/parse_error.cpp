@@ -0,0 +1,81 @@
+#include "parse_error.hpp"
+
+#include <algorithm>
+
+#include "detail/reader.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+std::string_view ToString(ParseErrorCode code)
+{
+    switch (code)
+    {
+    case ParseErrorCode::None: return "no error";
+    case ParseErrorCode::EmptyInput: return "empty input";
+    case ParseErrorCode::UnexpectedEnd: return "unexpected end of input";
+    case ParseErrorCode::UnexpectedCharacter: return "unexpected character";
+    case ParseErrorCode::InvalidLiteral: return "invalid literal";
+    case ParseErrorCode::InvalidNumber: return "invalid number";
+    case ParseErrorCode::NumberOutOfRange: return "number out of range";
+    case ParseErrorCode::UnterminatedString: return "unterminated string";
+    case ParseErrorCode::InvalidEscape: return "invalid escape sequence";
+    case ParseErrorCode::InvalidUtf8: return "invalid UTF-8";
+    case ParseErrorCode::TooDeep: return "nesting too deep";
+    case ParseErrorCode::TrailingCharacters: return "unexpected data after the document";
+    }
+    return "unknown error";
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+// NOTE: lines are only counted once parsing failed, the happy path does not
+// track them
+ParseError MakeParseError(std::string_view str, ParseErrorCode code, size_t offset)
+{
+    std::string_view before = str.substr(0, offset);
+    size_t line_start = before.rfind('\n');
+    line_start = line_start == std::string_view::npos ? 0 : line_start + 1;
+
+    return ParseError{
+        .code = code,
+        .offset = offset,
+        .line = static_cast<size_t>(std::count(before.begin(), before.end(), '\n')) + 1,
+        .column = offset - line_start + 1,
+    };
+}
+
+// =============================================================================
+
+void ThrowParseError(std::string_view str, const ParseError& error, const JsonDeserializeOptions& options)
+{
+    switch (error.code)
+    {
+    case ParseErrorCode::EmptyInput:
+        throw JsonException("Bad JSON: empty input");
+    case ParseErrorCode::TooDeep:
+        throw JsonException("Bad JSON: nesting is deeper than {} levels", options.max_depth);
+    default:
+        throw JsonException("Bad JSON: {} at line {}, column {}: `{}...`", ToString(error.code), error.line,
+                            error.column, str.substr(error.offset, 32));
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
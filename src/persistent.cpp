@@ -0,0 +1,271 @@
+#include "persistent.hpp"
+
+#include "exceptions.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+PersistentNode::PersistentNode(const JsonNode& node) :
+    value_(nullptr)
+{
+    if (node.IsString())
+    {
+        value_ = std::make_shared<const std::string>(node.AsString());
+    }
+    else if (node.IsNumber())
+    {
+        value_ = Resolved(node.AsNumber());
+    }
+    else if (node.IsBool())
+    {
+        value_ = node.AsBool();
+    }
+    else if (node.IsArray())
+    {
+        Items items;
+        items.reserve(node.AsArray().Size());
+        for (const JsonNode& item: node.AsArray())
+            items.emplace_back(item);
+        value_ = std::make_shared<const Items>(std::move(items));
+    }
+    else if (node.IsObject())
+    {
+        Fields fields;
+        fields.reserve(node.AsObject().Size());
+        for (const auto& [key, item]: node.AsObject())
+            fields.emplace_back(key, PersistentNode{item});
+        value_ = std::make_shared<const Fields>(std::move(fields));
+    }
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::MakeObject(Fields fields)
+{
+    PersistentNode node;
+    node.value_ = std::make_shared<const Fields>(std::move(fields));
+    return node;
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::MakeArray(Items items)
+{
+    PersistentNode node;
+    node.value_ = std::make_shared<const Items>(std::move(items));
+    return node;
+}
+
+// =============================================================================
+
+size_t PersistentNode::Size() const
+{
+    return IsObject() ? AsObject().size() : AsArray().size();
+}
+
+// =============================================================================
+
+const PersistentNode* PersistentNode::Find(std::string_view field) const
+{
+    for (const Field& item: AsObject())
+    {
+        if (item.first == field)
+            return &item.second;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+
+const PersistentNode& PersistentNode::Get(std::string_view field) const
+{
+    const PersistentNode* node = Find(field);
+    if (!node)
+        throw JsonException("Unknown object field: `{}`", field);
+    return *node;
+}
+
+// =============================================================================
+
+void PersistentNode::CheckBounds(size_t index) const
+{
+    if (index >= AsArray().size())
+        throw JsonException("Out of bounds: index {} exceeds array size {}", index, AsArray().size());
+}
+
+// =============================================================================
+
+const PersistentNode& PersistentNode::At(size_t index) const
+{
+    CheckBounds(index);
+    return AsArray()[index];
+}
+
+// =============================================================================
+
+bool PersistentNode::IsSameAs(const PersistentNode& other) const
+{
+    if (value_.index() != other.value_.index())
+        return false;
+
+    if (IsNumber())
+    {
+        const JsonNumber& a = AsNumber();
+        const JsonNumber& b = other.AsNumber();
+        if (a.GetType() != b.GetType())
+            return false;
+        if (a.IsInt64())
+            return a.To<int64_t>() == b.To<int64_t>();
+        if (a.IsUInt64())
+            return a.To<uint64_t>() == b.To<uint64_t>();
+        return a.To<double>() == b.To<double>();
+    }
+
+    // NOTE: pointers for strings and containers, values for bool and null
+    return std::visit([&](const auto& value) {
+        return value == std::get<std::decay_t<decltype(value)>>(other.value_);
+    }, value_);
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::Set(std::string_view field, PersistentNode value) const
+{
+    Fields fields = AsObject();
+    PersistentNode* existing = nullptr;
+    for (Field& item: fields)
+    {
+        if (item.first == field)
+        {
+            existing = &item.second;
+            break;
+        }
+    }
+
+    if (existing)
+        *existing = std::move(value);
+    else
+        fields.emplace_back(field, std::move(value));
+    return MakeObject(std::move(fields));
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::Set(size_t index, PersistentNode value) const
+{
+    CheckBounds(index);
+    Items items = AsArray();
+    items[index] = std::move(value);
+    return MakeArray(std::move(items));
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::Erase(std::string_view field) const
+{
+    if (!Has(field))
+        return *this;
+
+    Fields fields;
+    fields.reserve(Size() - 1);
+    for (const Field& item: AsObject())
+    {
+        if (item.first != field)
+            fields.push_back(item);
+    }
+    return MakeObject(std::move(fields));
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::Erase(size_t index) const
+{
+    CheckBounds(index);
+    Items items = AsArray();
+    items.erase(items.begin() + static_cast<ptrdiff_t>(index));
+    return MakeArray(std::move(items));
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::PushBack(PersistentNode value) const
+{
+    Items items;
+    items.reserve(Size() + 1);
+    items = AsArray();
+    items.push_back(std::move(value));
+    return MakeArray(std::move(items));
+}
+
+// =============================================================================
+
+// NOTE: recurses once per path item, the path is as long as the caller made it
+template<typename Modify>
+PersistentNode PersistentNode::ModifyIn(const PathItem* first, const PathItem* last, Modify&& modify) const
+{
+    if (first == last)
+        throw JsonException("Empty path");
+    if (first + 1 == last)
+        return modify(*this, *first);
+
+    if (first->IsKey())
+        return Set(first->Key(), Get(first->Key()).ModifyIn(first + 1, last, modify));
+    return Set(first->Index(), At(first->Index()).ModifyIn(first + 1, last, modify));
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::SetIn(Path path, PersistentNode value) const
+{
+    return ModifyIn(path.begin(), path.end(), [&](const PersistentNode& parent, const PathItem& item) {
+        return item.IsKey() ? parent.Set(item.Key(), std::move(value)) : parent.Set(item.Index(), std::move(value));
+    });
+}
+
+// =============================================================================
+
+PersistentNode PersistentNode::EraseIn(Path path) const
+{
+    return ModifyIn(path.begin(), path.end(), [](const PersistentNode& parent, const PathItem& item) {
+        return item.IsKey() ? parent.Erase(item.Key()) : parent.Erase(item.Index());
+    });
+}
+
+// =============================================================================
+
+JsonNode PersistentNode::Materialize() const
+{
+    if (IsString())
+        return JsonNode{AsString()};
+    if (IsNumber())
+        return JsonNode{AsNumber()};
+    if (IsBool())
+        return JsonNode{AsBool()};
+    if (IsNull())
+        return JsonNode{nullptr};
+
+    if (IsArray())
+    {
+        JsonArray array;
+        array.Reserve(AsArray().size());
+        for (const PersistentNode& item: AsArray())
+            array.PushBack(item.Materialize());
+        return JsonNode{std::move(array)};
+    }
+
+    JsonObject object;
+    object.Reserve(AsObject().size());
+    for (const auto& [key, item]: AsObject())
+        object.AddField(key.Str(), item.Materialize());
+    return JsonNode{std::move(object)};
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
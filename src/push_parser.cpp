@@ -0,0 +1,273 @@
+#include "push_parser.hpp"
+
+#include "detail/reader.hpp"
+#include "detail/simd.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Bytes that end a number or a literal
+bool IsDelimiter(char c)
+{
+    switch (c)
+    {
+    case ',': case ']': case '}': case ':': case '[': case '{': case '"':
+        return true;
+    default:
+        return mj::detail::IsWhitespace(c);
+    }
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+PushParser::PushParser(const JsonDeserializeOptions& options) : options_(options)
+{}
+
+// =============================================================================
+
+void PushParser::Feed(std::string_view chunk)
+{
+    size_t pos = 0;
+
+    // Finish the token left over from the previous chunk first
+    if (token_kind_ != Token::None)
+    {
+        size_t end = ScanToken(chunk, 0);
+        token_.append(chunk.substr(0, end));
+        if (token_kind_ != Token::None)
+        {
+            offset_ += chunk.size();
+            return;
+        }
+
+        OnToken(token_);
+        token_.clear();
+        pos = end;
+    }
+
+    while (true)
+    {
+        pos = detail::SkipWhitespaces(chunk, pos);
+        if (pos == chunk.size())
+            break;
+
+        char c = chunk[pos];
+        switch (c)
+        {
+        case '{': case '[': case '}': case ']': case ',': case ':':
+            token_offset_ = offset_ + pos;
+            OnStructural(c);
+            pos++;
+            continue;
+        default:
+            break;
+        }
+
+        if (expect_ != Expect::Value && expect_ != Expect::ValueOrEnd &&
+            expect_ != Expect::Key && expect_ != Expect::KeyOrEnd)
+        {
+            Fail(offset_ + pos);
+        }
+
+        size_t start = pos;
+        token_kind_ = (c == '"') ? Token::String : Token::Scalar;
+        token_offset_ = offset_ + pos;
+
+        size_t end = ScanToken(chunk, (c == '"') ? pos + 1 : pos);
+        if (token_kind_ != Token::None)
+        {
+            token_.assign(chunk.substr(start));
+            break;
+        }
+
+        // NOTE: tokens that fit into the chunk are parsed in place, without a copy
+        OnToken(chunk.substr(start, end - start));
+        pos = end;
+    }
+
+    offset_ += chunk.size();
+}
+
+// =============================================================================
+
+JsonNode PushParser::Finish()
+{
+    if (token_kind_ == Token::String)
+        throw JsonException("Bad JSON: unterminated string at offset {}", token_offset_);
+
+    if (token_kind_ == Token::Scalar)
+    {
+        OnToken(token_);
+        token_.clear();
+    }
+
+    if (expect_ != Expect::Nothing)
+    {
+        if (expect_ == Expect::Value && containers_.empty())
+            throw JsonException("Bad JSON: empty input");
+        throw JsonException("Bad JSON: unexpected end of input at offset {}", offset_);
+    }
+
+    JsonNode result = std::move(builder_.Result());
+    *this = PushParser{options_};
+    return result;
+}
+
+// =============================================================================
+
+// Position of the first byte after the current token. The token is still
+// open afterwards if it goes on in the next chunk.
+size_t PushParser::ScanToken(std::string_view chunk, size_t pos)
+{
+    if (token_kind_ == Token::Scalar)
+    {
+        while (pos < chunk.size() && !IsDelimiter(chunk[pos]))
+            pos++;
+        if (pos < chunk.size())
+            token_kind_ = Token::None;
+        return pos;
+    }
+
+    if (escaped_)
+    {
+        if (pos == chunk.size())
+            return pos;
+        escaped_ = false;
+        pos++;
+    }
+
+    while (true)
+    {
+        pos = detail::FindQuoteOrBackslash(chunk, pos);
+        if (pos >= chunk.size())
+            return chunk.size();
+
+        if (chunk[pos] == '"')
+        {
+            token_kind_ = Token::None;
+            return pos + 1;
+        }
+
+        if (pos + 1 == chunk.size())
+        {
+            escaped_ = true;
+            return chunk.size();
+        }
+        pos += 2;
+    }
+}
+
+// =============================================================================
+
+// Scalars and keys go through the same grammar as ParseFrom, so both parsers
+// accept exactly the same tokens
+void PushParser::OnToken(std::string_view token)
+{
+    token_kind_ = Token::None;
+
+    detail::ScanCursor cursor{token};
+    detail::Reader<detail::ScanCursor, detail::DomBuilder> reader{cursor, builder_, options_};
+
+    bool is_key = (expect_ == Expect::Key || expect_ == Expect::KeyOrEnd);
+    bool ok = is_key ? reader.ParseKey() : reader.ParseValue();
+    if (!ok || !cursor.AtEnd())
+        throw JsonException("Bad JSON: unexpected `{}` at offset {}", token.substr(0, 64), token_offset_);
+
+    if (is_key)
+        expect_ = Expect::Colon;
+    else
+        OnValue();
+}
+
+// =============================================================================
+
+void PushParser::OnStructural(char c)
+{
+    switch (c)
+    {
+    case '{': case '[':
+        if (expect_ != Expect::Value && expect_ != Expect::ValueOrEnd)
+            Fail(token_offset_);
+        if (containers_.size() >= options_.max_depth)
+            throw JsonException("Bad JSON: nesting is deeper than {} levels", options_.max_depth);
+
+        if (c == '{')
+            builder_.StartObject();
+        else
+            builder_.StartArray();
+
+        containers_.push_back({c == '{', 0});
+        expect_ = (c == '{') ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+        break;
+
+    case '}': case ']':
+    {
+        bool is_object = (c == '}');
+        Expect empty = is_object ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+        if (containers_.empty() || containers_.back().is_object != is_object ||
+            (expect_ != empty && expect_ != Expect::CommaOrEnd))
+        {
+            Fail(token_offset_);
+        }
+
+        size_t count = containers_.back().count;
+        containers_.pop_back();
+        if (is_object)
+            builder_.EndObject(count);
+        else
+            builder_.EndArray(count);
+        OnValue();
+        break;
+    }
+
+    case ',':
+        if (expect_ != Expect::CommaOrEnd)
+            Fail(token_offset_);
+        expect_ = containers_.back().is_object ? Expect::Key : Expect::Value;
+        break;
+
+    case ':':
+        if (expect_ != Expect::Colon)
+            Fail(token_offset_);
+        expect_ = Expect::Value;
+        break;
+    }
+}
+
+// =============================================================================
+
+void PushParser::OnValue()
+{
+    if (containers_.empty())
+    {
+        expect_ = Expect::Nothing;
+        return;
+    }
+
+    containers_.back().count++;
+    expect_ = Expect::CommaOrEnd;
+}
+
+// =============================================================================
+
+void PushParser::Fail(size_t offset) const
+{
+    throw JsonException("Bad JSON: unexpected character at offset {}", offset);
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
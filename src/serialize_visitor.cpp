@@ -1,10 +1,12 @@
 #include "serialize_visitor.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <cmath>
-#include <iomanip>
 #include <variant>
 
+#include "detail/escape.hpp"
+
 // =============================================================================
 
 namespace mj
@@ -28,37 +30,61 @@ void JsonSerializeVisitor::operator()(const JsonNode &n)
 
 void JsonSerializeVisitor::operator()(const JsonString& s)
 {
-    stream_ << "\"" << s << "\"";
+    stream_ << '"';
+    detail::WriteEscaped(stream_, s);
+    stream_ << '"';
 }
 
 // =============================================================================
 
 void JsonSerializeVisitor::operator()(const JsonNumber& n)
 {
-    if (options_.strict && !std::isfinite(n))
-        throw JsonException("non-finite numbers (nan, +-inf) are not allowed in strict mode");
-
-    if (std::isnan(n))
+    if (n.IsRaw())
     {
-        stream_ << "NaN";
+        std::string_view text = n.RawText();
+        stream_.write(text.data(), text.size());
         return;
     }
-    if (std::isinf(n))
+
+    // NOTE: integers never go through floating point, doubles are written in
+    // the shortest form that reads back to the same value
+    char buffer[32];
+    std::to_chars_result result{buffer, std::errc{}};
+    switch (n.GetType())
     {
-        if (n < 0.0) stream_ << "-";
-        stream_ << "Infinity";
-        return;
+    case JsonNumber::Type::Int64:
+        result = std::to_chars(buffer, buffer + sizeof(buffer), n.To<int64_t>());
+        break;
+    case JsonNumber::Type::UInt64:
+        result = std::to_chars(buffer, buffer + sizeof(buffer), n.To<uint64_t>());
+        break;
+    case JsonNumber::Type::Double:
+        if (!std::isfinite(n.To<double>()))
+        {
+            SerializeNonFinite(n);
+            return;
+        }
+        result = std::to_chars(buffer, buffer + sizeof(buffer), n.To<double>());
+        break;
     }
 
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(12) << n;
-    std::string result = ss.str();
+    stream_.write(buffer, result.ptr - buffer);
+}
 
-    result.erase(result.find_last_not_of('0') + 1, std::string::npos);
-    if (result.back() == '.')
-        result.pop_back();
+// =============================================================================
 
-    stream_ << result;
+void JsonSerializeVisitor::SerializeNonFinite(double n)
+{
+    if (options_.strict)
+        throw JsonException("non-finite numbers (nan, +-inf) are not allowed in strict mode");
+
+    if (std::isnan(n))
+    {
+        stream_ << "NaN";
+        return;
+    }
+    if (n < 0.0) stream_ << "-";
+    stream_ << "Infinity";
 }
 
 // =============================================================================
@@ -144,7 +170,9 @@ void JsonSerializeVisitor::SerializeObjectField(const std::string& key, const Js
         stream_ << options_.element_sep;
         AddNewLineIfPretty();
     }
-    SerializeArgs("\"", key, "\"", options_.field_sep);
+    SerializeArgs("\"");
+    detail::WriteEscaped(stream_, key);
+    stream_ << '"' << options_.field_sep;
     std::visit(*this, node.Value());
     is_first = false;
 }
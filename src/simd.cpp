@@ -0,0 +1,609 @@
+#include "detail/simd.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MJ_X86 1
+#endif
+
+// =============================================================================
+
+namespace
+{
+
+using mj::detail::SimdLevel;
+
+// =============================================================================
+
+inline bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// =============================================================================
+
+size_t FindQuoteOrBackslashScalar(std::string_view str, size_t pos)
+{
+    for (; pos < str.size(); pos++)
+    {
+        if (str[pos] == '"' || str[pos] == '\\')
+            return pos;
+    }
+    return str.size();
+}
+
+// =============================================================================
+
+size_t SkipWhitespacesScalar(std::string_view str, size_t pos)
+{
+    while (pos < str.size() && IsWhitespace(str[pos]))
+        pos++;
+    return pos;
+}
+
+// =============================================================================
+
+size_t CopyUntilBackslashScalar(std::string_view str, size_t pos, char* out)
+{
+    for (; pos < str.size() && str[pos] != '\\'; pos++)
+        *out++ = str[pos];
+    return pos;
+}
+
+// =============================================================================
+
+// NOTE: byte ranges of the well-formed sequences from table 3-7 of the
+// Unicode standard: overlong forms, surrogates and code points above
+// U+10FFFF are rejected
+bool ValidateUtf8Scalar(std::string_view str)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(str.data());
+    const unsigned char* end = p + str.size();
+    while (p != end)
+    {
+        if (end - p >= 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if ((word & 0x8080808080808080) == 0)
+            {
+                p += 8;
+                continue;
+            }
+        }
+
+        unsigned char c = *p;
+        if (c < 0x80)
+        {
+            p++;
+            continue;
+        }
+
+        ptrdiff_t size;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF)
+        {
+            size = 2;
+        }
+        else if (c >= 0xE0 && c <= 0xEF)
+        {
+            size = 3;
+            low = c == 0xE0 ? 0xA0 : low;
+            high = c == 0xED ? 0x9F : high;
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            size = 4;
+            low = c == 0xF0 ? 0x90 : low;
+            high = c == 0xF4 ? 0x8F : high;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (end - p < size || p[1] < low || p[1] > high)
+            return false;
+        for (ptrdiff_t i = 2; i < size; i++)
+        {
+            if ((p[i] & 0xC0) != 0x80)
+                return false;
+        }
+        p += size;
+    }
+    return true;
+}
+
+// =============================================================================
+
+#ifdef MJ_X86
+
+__attribute__((target("sse4.2")))
+size_t FindQuoteOrBackslashSse42(std::string_view str, size_t pos)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; pos + 16 <= str.size(); pos += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+        uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(in, quote), _mm_cmpeq_epi8(in, backslash)));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return FindQuoteOrBackslashScalar(str, pos);
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+size_t FindQuoteOrBackslashAvx2(std::string_view str, size_t pos)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    for (; pos + 32 <= str.size(); pos += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + pos));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote),
+                                                             _mm256_cmpeq_epi8(in, backslash)));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return FindQuoteOrBackslashSse42(str, pos);
+}
+
+// =============================================================================
+
+__attribute__((target("sse4.2")))
+size_t SkipWhitespacesSse42(std::string_view str, size_t pos)
+{
+    for (; pos + 16 <= str.size(); pos += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(in, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(in, _mm_set1_epi8('\r'))));
+        uint32_t mask = ~_mm_movemask_epi8(ws) & 0xFFFF;
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return SkipWhitespacesScalar(str, pos);
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+size_t SkipWhitespacesAvx2(std::string_view str, size_t pos)
+{
+    for (; pos + 32 <= str.size(); pos += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + pos));
+        __m256i ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('\r'))));
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return SkipWhitespacesSse42(str, pos);
+}
+
+// =============================================================================
+
+// NOTE: every block is stored before it is checked, so the bytes in front of
+// the backslash are already in place when it is found
+__attribute__((target("sse4.2")))
+size_t CopyUntilBackslashSse42(std::string_view str, size_t pos, char* out)
+{
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    for (; pos + 16 <= str.size(); pos += 16, out += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), in);
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(in, backslash));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return CopyUntilBackslashScalar(str, pos, out);
+}
+
+// =============================================================================
+
+// NOTE: UTF-8 validation with three table lookups per block (Keiser and
+// Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"). The
+// high and low nibbles of every byte and the high nibble of the byte after
+// it each select a set of error bits, a byte pair is malformed when all
+// three sets share a bit. Only the 3rd and 4th bytes of a sequence need
+// the bytes further back: they must be continuations exactly when a 3 or 4
+// byte lead precedes them.
+enum Utf8Error : uint8_t
+{
+    TOO_SHORT = 1 << 0,         // lead or ASCII byte where a continuation was due
+    TOO_LONG = 1 << 1,          // continuation after an ASCII byte
+    OVERLONG_3 = 1 << 2,
+    TOO_LARGE = 1 << 3,
+    SURROGATE = 1 << 4,
+    OVERLONG_2 = 1 << 5,
+    TOO_LARGE_1000 = 1 << 6,
+    OVERLONG_4 = 1 << 6,
+    TWO_CONTS = 1 << 7,         // continuation after a continuation
+    CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS,
+};
+
+alignas(16) constexpr uint8_t BYTE_1_HIGH[16] = {
+    // 0___ ASCII
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    // 10__ continuation
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    // 1100, 1101 two byte lead
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    // 1110 three byte lead
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    // 1111 four byte lead
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+};
+
+alignas(16) constexpr uint8_t BYTE_1_LOW[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY,
+    CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+};
+
+alignas(16) constexpr uint8_t BYTE_2_HIGH[16] = {
+    // 0___ ASCII
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    // 1000, 1001, 101_ continuation
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    // 11__ lead
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+};
+
+// Bytes above these in the last three positions of a block start a sequence
+// that runs into the next block
+alignas(32) constexpr uint8_t MAX_COMPLETE[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+// =============================================================================
+
+__attribute__((target("sse4.2")))
+inline __m128i Table(const uint8_t* bytes)
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+}
+
+// =============================================================================
+
+__attribute__((target("sse4.2")))
+inline __m128i Utf8Errors(__m128i input, __m128i prev_input)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i byte_1_high = _mm_shuffle_epi8(Table(BYTE_1_HIGH), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    __m128i byte_1_low = _mm_shuffle_epi8(Table(BYTE_1_LOW), _mm_and_si128(prev1, nibble));
+    __m128i byte_2_high = _mm_shuffle_epi8(Table(BYTE_2_HIGH), _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 14), _mm_set1_epi8(0xE0 - 0x80));
+    __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 13), _mm_set1_epi8(0xF0 - 0x80));
+    __m128i must_continue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(must_continue, special);
+}
+
+// =============================================================================
+
+__attribute__((target("sse4.2")))
+bool ValidateUtf8Sse42(std::string_view str)
+{
+    const __m128i max_complete = _mm_load_si128(reinterpret_cast<const __m128i*>(MAX_COMPLETE + 16));
+
+    __m128i error = _mm_setzero_si128();
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    auto check = [&](__m128i input) __attribute__((target("sse4.2"))) {
+        if (_mm_movemask_epi8(input) == 0)
+        {
+            error = _mm_or_si128(error, prev_incomplete);
+            prev_incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            error = _mm_or_si128(error, Utf8Errors(input, prev_input));
+            prev_incomplete = _mm_subs_epu8(input, max_complete);
+        }
+        prev_input = input;
+    };
+
+    size_t pos = 0;
+    for (; pos + 16 <= str.size(); pos += 16)
+        check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + pos)));
+    if (pos < str.size())
+    {
+        // NOTE: the padding is ASCII, a sequence cut short by the end shows
+        // up as TOO_SHORT
+        alignas(16) char tail[16] = {};
+        std::memcpy(tail, str.data() + pos, str.size() - pos);
+        check(_mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+    }
+    error = _mm_or_si128(error, prev_incomplete);
+    return _mm_testz_si128(error, error);
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+size_t CopyUntilBackslashAvx2(std::string_view str, size_t pos, char* out)
+{
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    for (; pos + 32 <= str.size(); pos += 32, out += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + pos));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), in);
+        uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, backslash));
+        if (mask)
+            return pos + std::countr_zero(mask);
+    }
+    return CopyUntilBackslashSse42(str, pos, out);
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+inline __m256i Table256(const uint8_t* bytes)
+{
+    return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(bytes)));
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+inline __m256i Utf8Errors(__m256i input, __m256i prev_input)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    // NOTE: alignr works within 128-bit lanes, the lane below is brought
+    // next to the input first
+    __m256i shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    __m256i byte_1_high = _mm256_shuffle_epi8(Table256(BYTE_1_HIGH), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    __m256i byte_1_low = _mm256_shuffle_epi8(Table256(BYTE_1_LOW), _mm256_and_si256(prev1, nibble));
+    __m256i byte_2_high = _mm256_shuffle_epi8(Table256(BYTE_2_HIGH), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    __m256i must_continue = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                             _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must_continue, special);
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+bool ValidateUtf8Avx2(std::string_view str)
+{
+    const __m256i max_complete = _mm256_load_si256(reinterpret_cast<const __m256i*>(MAX_COMPLETE));
+
+    __m256i error = _mm256_setzero_si256();
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    auto check = [&](__m256i input) __attribute__((target("avx2"))) {
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            error = _mm256_or_si256(error, prev_incomplete);
+            prev_incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            error = _mm256_or_si256(error, Utf8Errors(input, prev_input));
+            prev_incomplete = _mm256_subs_epu8(input, max_complete);
+        }
+        prev_input = input;
+    };
+
+    size_t pos = 0;
+    for (; pos + 32 <= str.size(); pos += 32)
+        check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(str.data() + pos)));
+    if (pos < str.size())
+    {
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, str.data() + pos, str.size() - pos);
+        check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    }
+    error = _mm256_or_si256(error, prev_incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+#endif // MJ_X86
+
+// =============================================================================
+
+using Kernel = size_t(*)(std::string_view, size_t);
+using CopyKernel = size_t(*)(std::string_view, size_t, char*);
+using ValidateKernel = bool(*)(std::string_view);
+
+// =============================================================================
+
+Kernel SelectFindQuoteOrBackslash(SimdLevel level)
+{
+    switch (level)
+    {
+#ifdef MJ_X86
+    case SimdLevel::Avx2: return FindQuoteOrBackslashAvx2;
+    case SimdLevel::Sse42: return FindQuoteOrBackslashSse42;
+#endif
+    default: return FindQuoteOrBackslashScalar;
+    }
+}
+
+// =============================================================================
+
+Kernel SelectSkipWhitespaces(SimdLevel level)
+{
+    switch (level)
+    {
+#ifdef MJ_X86
+    case SimdLevel::Avx2: return SkipWhitespacesAvx2;
+    case SimdLevel::Sse42: return SkipWhitespacesSse42;
+#endif
+    default: return SkipWhitespacesScalar;
+    }
+}
+
+// =============================================================================
+
+ValidateKernel SelectValidateUtf8(SimdLevel level)
+{
+    switch (level)
+    {
+#ifdef MJ_X86
+    case SimdLevel::Avx2: return ValidateUtf8Avx2;
+    case SimdLevel::Sse42: return ValidateUtf8Sse42;
+#endif
+    default: return ValidateUtf8Scalar;
+    }
+}
+
+// =============================================================================
+
+CopyKernel SelectCopyUntilBackslash(SimdLevel level)
+{
+    switch (level)
+    {
+#ifdef MJ_X86
+    case SimdLevel::Avx2: return CopyUntilBackslashAvx2;
+    case SimdLevel::Sse42: return CopyUntilBackslashSse42;
+#endif
+    default: return CopyUntilBackslashScalar;
+    }
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+SimdLevel DetectSimdLevel()
+{
+    static const SimdLevel level = [] {
+#ifdef MJ_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return SimdLevel::Sse42;
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+// =============================================================================
+
+std::string_view ToString(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Avx2: return "avx2";
+    case SimdLevel::Sse42: return "sse4.2";
+    default: return "scalar";
+    }
+}
+
+// =============================================================================
+
+size_t FindQuoteOrBackslash(std::string_view str, size_t pos)
+{
+    static const Kernel kernel = SelectFindQuoteOrBackslash(DetectSimdLevel());
+    return kernel(str, pos);
+}
+
+// =============================================================================
+
+size_t FindQuoteOrBackslash(std::string_view str, size_t pos, SimdLevel level)
+{
+    return SelectFindQuoteOrBackslash(level)(str, pos);
+}
+
+// =============================================================================
+
+size_t SkipWhitespaces(std::string_view str, size_t pos)
+{
+    static const Kernel kernel = SelectSkipWhitespaces(DetectSimdLevel());
+    return kernel(str, pos);
+}
+
+// =============================================================================
+
+size_t SkipWhitespaces(std::string_view str, size_t pos, SimdLevel level)
+{
+    return SelectSkipWhitespaces(level)(str, pos);
+}
+
+// =============================================================================
+
+size_t CopyUntilBackslash(std::string_view str, size_t pos, char* out)
+{
+    static const CopyKernel kernel = SelectCopyUntilBackslash(DetectSimdLevel());
+    return kernel(str, pos, out);
+}
+
+// =============================================================================
+
+size_t CopyUntilBackslash(std::string_view str, size_t pos, char* out, SimdLevel level)
+{
+    return SelectCopyUntilBackslash(level)(str, pos, out);
+}
+
+// =============================================================================
+
+bool ValidateUtf8(std::string_view str)
+{
+    static const ValidateKernel kernel = SelectValidateUtf8(DetectSimdLevel());
+    return kernel(str);
+}
+
+// =============================================================================
+
+bool ValidateUtf8(std::string_view str, SimdLevel level)
+{
+    return SelectValidateUtf8(level)(str);
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
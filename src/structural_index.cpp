@@ -0,0 +1,286 @@
+#include "detail/structural_index.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MJ_X86 1
+#endif
+
+// =============================================================================
+
+namespace
+{
+
+using mj::detail::SimdLevel;
+
+// =============================================================================
+
+constexpr size_t BLOCK_SIZE = 64;
+
+// Character classes of one 64-byte block, bit i describes byte i
+struct BlockMasks
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t whitespace;
+    uint64_t op;
+};
+
+// =============================================================================
+
+BlockMasks ClassifyScalar(const char* block)
+{
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE; i++)
+    {
+        uint64_t bit = uint64_t{1} << i;
+        switch (block[i])
+        {
+        case '"': masks.quote |= bit; break;
+        case '\\': masks.backslash |= bit; break;
+        case ' ': case '\t': case '\n': case '\r': masks.whitespace |= bit; break;
+        case '{': case '}': case '[': case ']': case ':': case ',': masks.op |= bit; break;
+        default: break;
+        }
+    }
+    return masks;
+}
+
+// =============================================================================
+
+#ifdef MJ_X86
+
+// NOTE: `[` and `]` differ from `{` and `}` only in bit 0x20, so both pairs
+// are matched with two comparisons after setting that bit
+
+__attribute__((target("sse4.2")))
+inline uint64_t Mask(__m128i m)
+{
+    return static_cast<uint16_t>(_mm_movemask_epi8(m));
+}
+
+__attribute__((target("avx2")))
+inline uint64_t Mask(__m256i m)
+{
+    return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+// =============================================================================
+
+__attribute__((target("sse4.2")))
+BlockMasks ClassifySse42(const char* block)
+{
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE; i += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        __m128i lower = _mm_or_si128(in, _mm_set1_epi8(0x20));
+
+        masks.quote |= Mask(_mm_cmpeq_epi8(in, _mm_set1_epi8('"'))) << i;
+        masks.backslash |= Mask(_mm_cmpeq_epi8(in, _mm_set1_epi8('\\'))) << i;
+        masks.whitespace |= Mask(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(in, _mm_set1_epi8('\t'))),
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(in, _mm_set1_epi8('\r'))))) << i;
+        masks.op |= Mask(_mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+            _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8(':')), _mm_cmpeq_epi8(in, _mm_set1_epi8(','))))) << i;
+    }
+    return masks;
+}
+
+// =============================================================================
+
+__attribute__((target("avx2")))
+BlockMasks ClassifyAvx2(const char* block)
+{
+    BlockMasks masks{};
+    for (size_t i = 0; i < BLOCK_SIZE; i += 32)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        __m256i lower = _mm256_or_si256(in, _mm256_set1_epi8(0x20));
+
+        masks.quote |= Mask(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('"'))) << i;
+        masks.backslash |= Mask(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\\'))) << i;
+        masks.whitespace |= Mask(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('\t'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('\r'))))) << i;
+        masks.op |= Mask(_mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+            _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8(','))))) << i;
+    }
+    return masks;
+}
+
+#endif // MJ_X86
+
+// =============================================================================
+
+// State carried from one block to the next
+struct Carry
+{
+    uint64_t escaped = 0;     // bit 0: first byte of the block is escaped
+    uint64_t in_string = 0;   // all ones when the previous block ended inside a string
+    uint64_t scalar = 0;      // bit 0: last byte of the previous block belongs to a token
+};
+
+// =============================================================================
+
+// Bits of bytes preceded by an odd run of backslashes. Backslashes are rare,
+// so walking them one by one is cheaper than the branchless carry tricks
+uint64_t FindEscaped(uint64_t backslash, Carry& carry)
+{
+    uint64_t escaped = carry.escaped;
+    carry.escaped = 0;
+
+    while (backslash)
+    {
+        int i = std::countr_zero(backslash);
+        backslash &= backslash - 1;
+
+        if (escaped & (uint64_t{1} << i))
+            continue;
+
+        if (i == 63)
+            carry.escaped = 1;
+        else
+            escaped |= uint64_t{1} << (i + 1);
+    }
+    return escaped;
+}
+
+// =============================================================================
+
+// Bit i is the parity of set bits 0..i
+uint64_t PrefixXor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// =============================================================================
+
+uint64_t FindStructurals(const BlockMasks& masks, Carry& carry)
+{
+    uint64_t quote = masks.quote & ~FindEscaped(masks.backslash, carry);
+
+    // Opening quotes and string contents, closing quotes excluded
+    uint64_t in_string = PrefixXor(quote) ^ carry.in_string;
+    carry.in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+    uint64_t scalar = ~(masks.op | masks.whitespace | quote | in_string);
+    uint64_t token_start = scalar & ~((scalar << 1) | carry.scalar);
+    carry.scalar = scalar >> 63;
+
+    return (masks.op & ~in_string) | quote | token_start;
+}
+
+// =============================================================================
+
+// Writes positions of set bits at `out`, which must have room for 64 entries.
+// Unconditional batches of 8 keep the loop free of unpredictable branches for
+// typical blocks; the garbage written past the last bit is overwritten later.
+size_t WritePositions(uint64_t bits, uint32_t base, uint32_t* out)
+{
+    size_t count = std::popcount(bits);
+    for (size_t i = 0; i < count; i += 8)
+    {
+        for (size_t j = 0; j < 8; j++)
+        {
+            out[i + j] = base + std::countr_zero(bits);
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
+
+// =============================================================================
+
+template<BlockMasks (*Classify)(const char*)>
+[[gnu::always_inline]] inline bool BuildIndex(std::string_view str, std::vector<uint32_t>& positions)
+{
+    Carry carry;
+    size_t offset = 0;
+    size_t count = 0;
+
+    auto append = [&](uint64_t bits, size_t base) {
+        if (positions.size() < count + BLOCK_SIZE)
+            positions.resize(std::max(2 * positions.size(), count + BLOCK_SIZE));
+        count += WritePositions(bits, static_cast<uint32_t>(base), positions.data() + count);
+    };
+
+    for (; offset + BLOCK_SIZE <= str.size(); offset += BLOCK_SIZE)
+        append(FindStructurals(Classify(str.data() + offset), carry), offset);
+
+    if (offset < str.size())
+    {
+        char block[BLOCK_SIZE];
+        std::memset(block, ' ', BLOCK_SIZE);
+        std::memcpy(block, str.data() + offset, str.size() - offset);
+        append(FindStructurals(Classify(block), carry), offset);
+    }
+
+    positions.resize(count);
+    positions.push_back(static_cast<uint32_t>(str.size()));
+    return carry.in_string == 0;
+}
+
+// =============================================================================
+
+// NOTE: the whole block loop is compiled for the target instruction set, so
+// that classification gets inlined instead of being called per block
+
+#ifdef MJ_X86
+
+__attribute__((target("avx2")))
+bool BuildIndexAvx2(std::string_view str, std::vector<uint32_t>& positions)
+{
+    return BuildIndex<ClassifyAvx2>(str, positions);
+}
+
+__attribute__((target("sse4.2")))
+bool BuildIndexSse42(std::string_view str, std::vector<uint32_t>& positions)
+{
+    return BuildIndex<ClassifySse42>(str, positions);
+}
+
+#endif // MJ_X86
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+namespace mj::detail
+{
+
+// =============================================================================
+
+bool BuildStructuralIndex(std::string_view str, std::vector<uint32_t>& positions, SimdLevel level)
+{
+    // NOTE: typical documents have a structural every 4-8 bytes
+    positions.resize(str.size() / 8 + 1);
+
+    switch (level)
+    {
+#ifdef MJ_X86
+    case SimdLevel::Avx2: return BuildIndexAvx2(str, positions);
+    case SimdLevel::Sse42: return BuildIndexSse42(str, positions);
+#endif
+    default: return BuildIndex<ClassifyScalar>(str, positions);
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::detail
+
+// =============================================================================
@@ -0,0 +1,354 @@
+#include "tape.hpp"
+
+#include <bit>
+
+#include "detail/reader.hpp"
+#include "exceptions.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+constexpr int TAG_SHIFT = 56;
+constexpr uint64_t PAYLOAD_MASK = (uint64_t{1} << TAG_SHIFT) - 1;
+
+uint64_t Entry(char tag, uint64_t payload = 0)
+{
+    return (static_cast<uint64_t>(static_cast<uint8_t>(tag)) << TAG_SHIFT) | payload;
+}
+
+uint64_t Payload(uint64_t entry)
+{
+    return entry & PAYLOAD_MASK;
+}
+
+// =============================================================================
+
+// Event handler that appends to the tape. Open containers are remembered by
+// the index of their entry, which gets the index of the closing entry once
+// it is known.
+class TapeBuilder
+{
+public:
+    TapeBuilder(std::vector<uint64_t>& tape, std::string& strings) :
+        tape_(tape),
+        strings_(strings)
+    {}
+
+    bool StartObject() { return Open('{'); }
+    bool StartArray() { return Open('['); }
+
+    bool EndObject(size_t count) { return Close('}', count); }
+    bool EndArray(size_t count) { return Close(']', count); }
+
+    bool Key(std::string_view key) { return String(key); }
+
+    bool String(std::string_view str)
+    {
+        tape_.push_back(Entry('"', strings_.size()));
+        tape_.push_back(str.size());
+        strings_.append(str);
+        return true;
+    }
+
+    bool Number(const mj::JsonNumber& number)
+    {
+        switch (number.GetType())
+        {
+        case mj::JsonNumber::Type::Int64:
+            tape_.push_back(Entry('l'));
+            tape_.push_back(std::bit_cast<uint64_t>(number.To<int64_t>()));
+            break;
+        case mj::JsonNumber::Type::UInt64:
+            tape_.push_back(Entry('u'));
+            tape_.push_back(number.To<uint64_t>());
+            break;
+        default:
+            tape_.push_back(Entry('d'));
+            tape_.push_back(std::bit_cast<uint64_t>(number.To<double>()));
+            break;
+        }
+        return true;
+    }
+
+    bool Bool(bool b)
+    {
+        tape_.push_back(Entry(b ? 't' : 'f'));
+        return true;
+    }
+
+    bool Null()
+    {
+        tape_.push_back(Entry('n'));
+        return true;
+    }
+
+private:
+    bool Open(char tag)
+    {
+        open_.push_back(tape_.size());
+        tape_.push_back(Entry(tag));
+        return true;
+    }
+
+    bool Close(char tag, size_t count)
+    {
+        tape_[open_.back()] |= tape_.size();
+        open_.pop_back();
+        tape_.push_back(Entry(tag, count));
+        return true;
+    }
+
+private:
+    std::vector<uint64_t>& tape_;
+    std::string& strings_;
+    std::vector<size_t> open_;
+};
+
+} // namespace
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+char TapeValue::Tag() const
+{
+    return static_cast<char>(doc_->tape_[index_] >> TAG_SHIFT);
+}
+
+// =============================================================================
+
+void TapeValue::Expect(char tag, const char* name) const
+{
+    if (Tag() != tag)
+        throw JsonException("Bad type: {} expected", name);
+}
+
+// =============================================================================
+
+size_t TapeValue::Next() const
+{
+    switch (Tag())
+    {
+    case '{':
+    case '[':
+        return Payload(doc_->tape_[index_]) + 1;
+    case '"':
+    case 'l':
+    case 'u':
+    case 'd':
+        return index_ + 2;
+    default:
+        return index_ + 1;
+    }
+}
+
+// =============================================================================
+
+std::string_view TapeValue::AsString() const
+{
+    Expect('"', "string");
+    return std::string_view{doc_->strings_}.substr(Payload(doc_->tape_[index_]), doc_->tape_[index_ + 1]);
+}
+
+// =============================================================================
+
+JsonNumber TapeValue::AsNumber() const
+{
+    switch (Tag())
+    {
+    case 'l': return JsonNumber{std::bit_cast<int64_t>(doc_->tape_[index_ + 1])};
+    case 'u': return JsonNumber{doc_->tape_[index_ + 1]};
+    case 'd': return JsonNumber{std::bit_cast<double>(doc_->tape_[index_ + 1])};
+    default: throw JsonException("Bad type: number expected");
+    }
+}
+
+// =============================================================================
+
+JsonBool TapeValue::AsBool() const
+{
+    if (!IsBool())
+        throw JsonException("Bad type: bool expected");
+    return Tag() == 't';
+}
+
+// =============================================================================
+
+JsonNull TapeValue::AsNull() const
+{
+    Expect('n', "null");
+    return nullptr;
+}
+
+// =============================================================================
+
+TapeObject TapeValue::AsObject() const
+{
+    Expect('{', "object");
+    return TapeObject{doc_, index_};
+}
+
+// =============================================================================
+
+TapeArray TapeValue::AsArray() const
+{
+    Expect('[', "array");
+    return TapeArray{doc_, index_};
+}
+
+// =============================================================================
+
+JsonNode TapeValue::Materialize() const
+{
+    if (IsString())
+        return JsonNode{JsonString{AsString()}};
+    if (IsNumber())
+        return JsonNode{AsNumber()};
+    if (IsBool())
+        return JsonNode{AsBool()};
+    if (IsNull())
+        return JsonNode{nullptr};
+
+    if (IsArray())
+    {
+        TapeArray items = AsArray();
+        JsonArray array;
+        array.Reserve(items.Size());
+        for (const TapeValue& item: items)
+            array.PushBack(item.Materialize());
+        return JsonNode{std::move(array)};
+    }
+
+    TapeObject fields = AsObject();
+    JsonObject object;
+    object.Reserve(fields.Size());
+    for (const auto& [key, value]: fields)
+        object.AddField(std::string{key}, value.Materialize());
+    return JsonNode{std::move(object)};
+}
+
+// =============================================================================
+
+TapeObject::Iterator::Iterator(const TapeDocument* doc, size_t index) :
+    doc_(doc),
+    index_(index),
+    field_({}, TapeValue{doc, index})
+{
+    // NOTE: the end iterator sits on `}`
+    TapeValue key{doc_, index_};
+    if (key.IsString())
+        field_ = {key.AsString(), TapeValue{doc_, key.Next()}};
+}
+
+// =============================================================================
+
+TapeObject::Iterator& TapeObject::Iterator::operator++()
+{
+    *this = Iterator{doc_, field_.second.Next()};
+    return *this;
+}
+
+// =============================================================================
+
+bool TapeObject::Find(std::string_view field, size_t* value_index) const
+{
+    for (auto it = begin(), last = end(); it != last; ++it)
+    {
+        if (it->first == field)
+        {
+            if (value_index)
+                *value_index = it->second.index_;
+            return true;
+        }
+    }
+    return false;
+}
+
+// =============================================================================
+
+TapeValue TapeObject::Get(std::string_view field) const
+{
+    size_t value_index;
+    if (!Find(field, &value_index))
+        throw JsonException("Unknown object field: `{}`", field);
+    return TapeValue{doc_, value_index};
+}
+
+// =============================================================================
+
+size_t TapeObject::Size() const
+{
+    return Payload(doc_->tape_[Payload(doc_->tape_[index_])]);
+}
+
+// =============================================================================
+
+TapeObject::Iterator TapeObject::begin() const
+{
+    return Iterator{doc_, index_ + 1};
+}
+
+// =============================================================================
+
+TapeObject::Iterator TapeObject::end() const
+{
+    return Iterator{doc_, Payload(doc_->tape_[index_])};
+}
+
+// =============================================================================
+
+TapeValue TapeArray::At(size_t index) const
+{
+    if (index >= Size())
+        throw JsonException("Out of bounds: index {} exceeds array size {}", index, Size());
+
+    auto it = begin();
+    for (size_t i = 0; i < index; i++)
+        ++it;
+    return *it;
+}
+
+// =============================================================================
+
+size_t TapeArray::Size() const
+{
+    return Payload(doc_->tape_[Payload(doc_->tape_[index_])]);
+}
+
+// =============================================================================
+
+TapeArray::Iterator TapeArray::begin() const
+{
+    return Iterator{doc_, index_ + 1};
+}
+
+// =============================================================================
+
+TapeArray::Iterator TapeArray::end() const
+{
+    return Iterator{doc_, Payload(doc_->tape_[index_])};
+}
+
+// =============================================================================
+
+// NOTE: decoded strings are never longer than their JSON text, so the string
+// buffer never grows; a tape word per four bytes of input is a guess
+TapeDocument::TapeDocument(std::string_view str, const JsonDeserializeOptions& options)
+{
+    tape_.reserve(str.size() / 4 + 1);
+    strings_.reserve(str.size());
+
+    TapeBuilder builder{tape_, strings_};
+    detail::ReadDocument(str, builder, options);
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
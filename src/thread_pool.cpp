@@ -0,0 +1,104 @@
+#include "thread_pool.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    for (size_t i = 1; i < threads; i++)
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+// =============================================================================
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (std::thread& worker: workers_)
+        worker.join();
+}
+
+// =============================================================================
+
+void ThreadPool::Run(size_t count, const std::function<void(size_t)>& task)
+{
+    std::lock_guard run_lock(run_mutex_);
+
+    {
+        std::lock_guard lock(mutex_);
+        task_ = &task;
+        count_ = count;
+        next_ = 0;
+        busy_ = workers_.size();
+        error_ = nullptr;
+        generation_++;
+    }
+    wake_.notify_all();
+
+    Work();
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    task_ = nullptr;
+
+    if (error_)
+        std::rethrow_exception(error_);
+}
+
+// =============================================================================
+
+void ThreadPool::WorkerLoop()
+{
+    size_t seen_generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+            if (stop_)
+                return;
+            seen_generation = generation_;
+        }
+
+        Work();
+
+        std::lock_guard lock(mutex_);
+        if (--busy_ == 0)
+            done_.notify_one();
+    }
+}
+
+// =============================================================================
+
+// Takes task indices until there are none left
+void ThreadPool::Work()
+{
+    for (size_t index = next_++; index < count_; index = next_++)
+    {
+        try
+        {
+            (*task_)(index);
+        }
+        catch (...)
+        {
+            std::lock_guard lock(mutex_);
+            if (!error_)
+                error_ = std::current_exception();
+        }
+    }
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,106 @@
+#include "view.hpp"
+
+#include "detail/reader.hpp"
+#include "detail/view_builder.hpp"
+
+// =============================================================================
+
+namespace mj
+{
+
+// =============================================================================
+
+const ViewNode& ViewArray::At(size_t index) const
+{
+    if (index >= Size())
+        throw JsonException("Out of bounds: index {} exceeds array size {}", index, Size());
+    return nodes_[index];
+}
+
+// =============================================================================
+
+const ViewNode* ViewObject::Find(std::string_view field) const
+{
+    for (const Field& item: fields_)
+    {
+        if (item.first == field)
+            return &item.second;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+
+const ViewNode& ViewObject::Get(std::string_view field) const
+{
+    const ViewNode* node = Find(field);
+    if (!node)
+        throw JsonException("Unknown object field: `{}`", field);
+    return *node;
+}
+
+// =============================================================================
+
+const ViewNode* ViewObject::Find(InternedKey field) const
+{
+    for (const Field& item: fields_)
+    {
+        if (item.first.data() == field.Data())
+            return &item.second;
+    }
+    return nullptr;
+}
+
+// =============================================================================
+
+const ViewNode& ViewObject::Get(InternedKey field) const
+{
+    const ViewNode* node = Find(field);
+    if (!node)
+        throw JsonException("Unknown object field: `{}`", field.View());
+    return *node;
+}
+
+// =============================================================================
+
+JsonNode ViewNode::Materialize() const
+{
+    if (IsString())
+        return JsonNode{JsonString{AsString()}};
+    if (IsNumber())
+        return JsonNode{AsNumber()};
+    if (IsBool())
+        return JsonNode{AsBool()};
+    if (IsNull())
+        return JsonNode{nullptr};
+
+    if (IsArray())
+    {
+        JsonArray array;
+        array.Reserve(AsArray().Size());
+        for (const ViewNode& node: AsArray())
+            array.PushBack(node.Materialize());
+        return JsonNode{std::move(array)};
+    }
+
+    JsonObject object;
+    object.Reserve(AsObject().Size());
+    for (const auto& [key, node]: AsObject())
+        object.AddField(std::string{key}, node.Materialize());
+    return JsonNode{std::move(object)};
+}
+
+// =============================================================================
+
+ViewNode ParseInSitu(std::span<char> buffer, const JsonDeserializeOptions& options)
+{
+    detail::ViewBuilder builder{buffer.data(), std::pmr::get_default_resource(), options.key_interner};
+    detail::ReadDocument(std::string_view{buffer.data(), buffer.size()}, builder, options);
+    return std::move(builder.Result());
+}
+
+// =============================================================================
+
+} // namespace mj
+
+// =============================================================================
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// =============================================================================
+
+namespace mj::bench
+{
+
+// =============================================================================
+
+using Args = std::vector<std::string>;
+using BenchmarkFunction = int(*)(const Args& args);
+
+// =============================================================================
+
+struct Registrar
+{
+    Registrar(const char* name, const char* description, BenchmarkFunction function);
+};
+
+#define MJ_BENCHMARK(name, description) \
+    static int Benchmark_##name(const mj::bench::Args& args); \
+    static mj::bench::Registrar registrar_##name(#name, description, Benchmark_##name); \
+    static int Benchmark_##name(const mj::bench::Args& args)
+
+// =============================================================================
+
+class Timer
+{
+public:
+    Timer() : start_(std::chrono::steady_clock::now()) {}
+
+    double Seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// =============================================================================
+
+// Best wall time of `repeats` runs of `f`, in seconds
+template<typename F>
+double Measure(F&& f, size_t repeats = 5)
+{
+    double best = 0.0;
+    for (size_t i = 0; i < repeats; i++)
+    {
+        Timer timer;
+        f();
+        double elapsed = timer.Seconds();
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// =============================================================================
+
+void Report(const std::string& name, size_t bytes, double seconds);
+
+size_t ArgOr(const Args& args, size_t index, size_t fallback);
+
+// =============================================================================
+
+// Documents of roughly `bytes` size used by several benchmarks
+std::string MakeNumberArray(size_t bytes);
+std::string MakeMixedArray(size_t bytes);
+
+// =============================================================================
+
+// Keeps the optimizer from dropping benchmarked results
+template<typename T>
+void DoNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// =============================================================================
+
+} // namespace mj::bench
+
+// =============================================================================
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <map>
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace mj::bench
+{
+
+// =============================================================================
+
+struct Benchmark
+{
+    std::string description;
+    BenchmarkFunction function;
+};
+
+std::map<std::string, Benchmark>& Registry()
+{
+    static std::map<std::string, Benchmark> registry;
+    return registry;
+}
+
+// =============================================================================
+
+Registrar::Registrar(const char* name, const char* description, BenchmarkFunction function)
+{
+    Registry().emplace(name, Benchmark{description, function});
+}
+
+// =============================================================================
+
+} // namespace mj::bench
+
+// =============================================================================
+
+int main(int argc, char* argv[])
+{
+    const auto& registry = mj::bench::Registry();
+
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <benchmark> [args...]\n\nBenchmarks:\n";
+        for (const auto& [name, benchmark]: registry)
+            std::cout << "  " << name << "\t" << benchmark.description << '\n';
+        return 0;
+    }
+
+    auto it = registry.find(argv[1]);
+    if (it == registry.end())
+    {
+        std::cerr << "Unknown benchmark: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    mj::bench::Args args(argv + 2, argv + argc);
+    return it->second.function(args);
+}
+
+// =============================================================================
@@ -0,0 +1,118 @@
+#include <malloc.h>
+
+#include <iostream>
+
+#include "compact.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Bytes currently allocated from the heap, big blocks are mapped separately (glibc)
+size_t HeapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// =============================================================================
+
+// Visits every node: sums the numbers and the string lengths
+double Walk(const mj::JsonNode& node)
+{
+    if (node.IsNumber())
+        return node.AsNumber();
+    if (node.IsString())
+        return static_cast<double>(node.AsString().size());
+
+    double sum = 0.0;
+    if (node.IsArray())
+    {
+        for (const mj::JsonNode& item: node.AsArray())
+            sum += Walk(item);
+    }
+    else if (node.IsObject())
+    {
+        for (const auto& [key, value]: node.AsObject())
+            sum += Walk(value);
+    }
+    return sum;
+}
+
+double Walk(const mj::CompactNode& node)
+{
+    if (node.IsNumber())
+        return node.AsNumber();
+    if (node.IsString())
+        return static_cast<double>(node.AsString().size());
+
+    double sum = 0.0;
+    if (node.IsArray())
+    {
+        for (const mj::CompactNode& item: node.AsArray())
+            sum += Walk(item);
+    }
+    else if (node.IsObject())
+    {
+        for (const mj::CompactField& field: node.AsObject())
+            sum += Walk(field.Value());
+    }
+    return sum;
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& doc)
+{
+    size_t before = HeapInUse();
+    mj::JsonNode node = mj::ParseFrom(doc);
+    size_t node_bytes = HeapInUse() - before;
+
+    before = HeapInUse();
+    mj::CompactDocument compact{doc};
+    size_t compact_bytes = HeapInUse() - before;
+
+    std::cout << name << ": JsonNode tree " << node_bytes / 1024 << " KB, CompactNode tree "
+              << compact_bytes / 1024 << " KB for " << doc.size() / 1024 << " KB of input" << std::endl;
+
+    double seconds = mj::bench::Measure([&] {
+        mj::bench::DoNotOptimize(Walk(node));
+    });
+    mj::bench::Report(name + ": walk JsonNode", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::bench::DoNotOptimize(Walk(compact.Root()));
+    });
+    mj::bench::Report(name + ": walk CompactNode", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode parsed = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(parsed);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::CompactDocument parsed{doc};
+        mj::bench::DoNotOptimize(parsed);
+    });
+    mj::bench::Report(name + ": CompactDocument", doc.size(), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench compact [size_mb=64]
+MJ_BENCHMARK(compact, "memory, traversal and parse time of CompactNode trees against JsonNode trees")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    Compare("numbers", mj::bench::MakeNumberArray(size_mb * 1024 * 1024));
+    Compare("mixed", mj::bench::MakeMixedArray(size_mb * 1024 * 1024));
+    return 0;
+}
+
+// =============================================================================
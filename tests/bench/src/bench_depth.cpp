@@ -0,0 +1,162 @@
+#include <stdexcept>
+
+#include "detail/dom_builder.hpp"
+#include "detail/reader.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+using mj::detail::IndexedCursor;
+
+// =============================================================================
+
+// The grammar as it was before the explicit stack: containers recurse into
+// ParseValue, scalars are handed over to the regular reader
+template<typename Handler>
+class RecursiveReader
+{
+public:
+    RecursiveReader(IndexedCursor& cursor, Handler& handler, const mj::JsonDeserializeOptions& options) :
+        cursor_(cursor),
+        handler_(handler),
+        scalars_(cursor, handler, options)
+    {}
+
+    bool ParseValue()
+    {
+        if (cursor_.AtEnd())
+            return false;
+
+        switch (cursor_.Peek())
+        {
+        case '[': return ParseArray();
+        case '{': return ParseObject();
+        case '"': return scalars_.ParseString();
+        case 't': case 'f': return scalars_.ParseBool();
+        case 'n': return scalars_.ParseNull();
+        default: return scalars_.ParseNumber();
+        }
+    }
+
+private:
+    bool ParseArray()
+    {
+        cursor_.Consume('[');
+        handler_.StartArray();
+
+        size_t count = 0;
+        if (!cursor_.Consume(']'))
+        {
+            while (true)
+            {
+                if (!ParseValue())
+                    return false;
+                count++;
+
+                if (cursor_.Consume(']'))
+                    break;
+                if (!cursor_.Consume(','))
+                    return false;
+            }
+        }
+        return handler_.EndArray(count);
+    }
+
+    bool ParseObject()
+    {
+        cursor_.Consume('{');
+        handler_.StartObject();
+
+        size_t count = 0;
+        if (!cursor_.Consume('}'))
+        {
+            while (true)
+            {
+                if (!scalars_.ParseKey() || !cursor_.Consume(':') || !ParseValue())
+                    return false;
+                count++;
+
+                if (cursor_.Consume('}'))
+                    break;
+                if (!cursor_.Consume(','))
+                    return false;
+            }
+        }
+        return handler_.EndObject(count);
+    }
+
+private:
+    IndexedCursor& cursor_;
+    Handler& handler_;
+    mj::detail::Reader<IndexedCursor, Handler> scalars_;
+};
+
+// =============================================================================
+
+// Accepts every event, leaves only the grammar itself to be measured
+struct NullHandler
+{
+    bool StartObject() { return true; }
+    bool Key(std::string_view) { return true; }
+    bool EndObject(size_t) { return true; }
+    bool StartArray() { return true; }
+    bool EndArray(size_t) { return true; }
+    bool String(std::string_view) { return true; }
+    bool Number(mj::JsonNumber) { return true; }
+    bool Bool(bool) { return true; }
+    bool Null() { return true; }
+};
+
+// =============================================================================
+
+template<template<typename> typename ReaderFor, typename Handler>
+void Run(const std::string& name, const std::string& doc, const std::vector<uint32_t>& positions)
+{
+    mj::JsonDeserializeOptions options;
+    double seconds = mj::bench::Measure([&] {
+        IndexedCursor cursor{doc, positions};
+        Handler handler;
+        ReaderFor<Handler> reader{cursor, handler, options};
+        if (!reader.ParseValue() || !cursor.AtEnd())
+            throw std::runtime_error("bad benchmark document");
+        mj::bench::DoNotOptimize(handler);
+    });
+    mj::bench::Report(name, doc.size(), seconds);
+}
+
+// =============================================================================
+
+template<typename Handler>
+using IterativeReader = mj::detail::Reader<IndexedCursor, Handler>;
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench depth [size_mb=64]
+//
+// Stage 2 only, the structural index is built once up front
+MJ_BENCHMARK(depth, "Iterative grammar against the recursive one on shallow documents")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+
+    for (auto [kind, doc]: {std::pair{"mixed", mj::bench::MakeMixedArray(size_mb * 1024 * 1024)},
+                            std::pair{"numbers", mj::bench::MakeNumberArray(size_mb * 1024 * 1024)}})
+    {
+        std::vector<uint32_t> positions;
+        mj::detail::BuildStructuralIndex(doc, positions);
+
+        std::string prefix = std::string(kind) + ": ";
+        Run<RecursiveReader, NullHandler>(prefix + "recursive, events", doc, positions);
+        Run<IterativeReader, NullHandler>(prefix + "iterative, events", doc, positions);
+        Run<RecursiveReader, mj::detail::DomBuilder>(prefix + "recursive, tree", doc, positions);
+        Run<IterativeReader, mj::detail::DomBuilder>(prefix + "iterative, tree", doc, positions);
+    }
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,59 @@
+#include <thread>
+
+#include "document.hpp"
+#include "parser.hpp"
+#include "thread_pool.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// NOTE: tree destruction is measured too, freeing node by node is half of
+// what the arena saves
+template<typename Parse>
+void ParseMany(const std::string& name, const std::string& doc, size_t count, mj::ThreadPool& pool, Parse parse)
+{
+    double seconds = mj::bench::Measure([&] {
+        pool.Run(count, [&](size_t) {
+            auto result = parse(doc);
+            mj::bench::DoNotOptimize(result);
+        });
+    });
+    mj::bench::Report(name, doc.size() * count, seconds);
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& doc, size_t count, mj::ThreadPool& pool)
+{
+    ParseMany(name + ": ParseFrom", doc, count, pool, [](const std::string& str) {
+        return mj::ParseFrom(str);
+    });
+    ParseMany(name + ": Document", doc, count, pool, [](const std::string& str) {
+        return mj::Document{str};
+    });
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench document [size_mb=64] [threads=hardware_concurrency]
+MJ_BENCHMARK(document, "ParseFrom against the arena-backed Document, one big and many small documents on a thread pool")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    size_t threads = mj::bench::ArgOr(args, 1, std::thread::hardware_concurrency());
+    mj::ThreadPool pool{threads};
+
+    Compare("big", mj::bench::MakeMixedArray(size_mb * 1024 * 1024), 1, pool);
+
+    // Request-sized documents: the allocator is the shared resource here
+    std::string small = mj::bench::MakeMixedArray(2 * 1024);
+    Compare("small x" + std::to_string(threads) + " threads", small, size_mb * 1024 * 1024 / small.size(), pool);
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,105 @@
+#include <cstring>
+#include <iterator>
+#include <sstream>
+
+#include "detail/escape.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// String body of about `size` bytes with an escape sequence every `period` bytes
+std::string MakeEscapedBody(size_t size, size_t period)
+{
+    static const std::string escapes[] = {"\\n", "\\\"", "\\\\", "\\/", "\\u00e9", "\\ud83d\\ude00"};
+
+    std::string body;
+    for (size_t i = 0; body.size() < size; i++)
+    {
+        body.append(period, static_cast<char>('a' + i % 26));
+        body += escapes[i % std::size(escapes)];
+    }
+    return body;
+}
+
+// =============================================================================
+
+std::string MakeStringArray(size_t bytes, const std::string& body)
+{
+    std::string result = "[";
+    result.reserve(bytes + body.size() + 8);
+    while (result.size() < bytes)
+    {
+        if (result.size() > 1)
+            result += ",\n";
+        result += '"';
+        result += body;
+        result += '"';
+    }
+    result += "]";
+    return result;
+}
+
+// =============================================================================
+
+// Decoding alone: the string body is decoded in place as ParseInSitu does it
+// (restoring the input is part of the measured time), and into a separate
+// buffer as the reader does it
+void RunDecode(const std::string& name, const std::string& body)
+{
+    std::string in_place(body.size(), '\0');
+    double seconds = mj::bench::Measure([&] {
+        std::memcpy(in_place.data(), body.data(), body.size());
+        mj::bench::DoNotOptimize(mj::detail::DecodeEscapes(in_place, in_place.data()));
+    }, 200);
+    mj::bench::Report(name + ": DecodeEscapes", body.size(), seconds);
+
+    std::string out(body.size(), '\0');
+    seconds = mj::bench::Measure([&] {
+        mj::bench::DoNotOptimize(mj::detail::DecodeEscapesCopy(body, out.data()));
+    }, 200);
+    mj::bench::Report(name + ": DecodeEscapesCopy", body.size(), seconds);
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, size_t size, size_t period)
+{
+    std::string body = MakeEscapedBody(4096, period);
+    RunDecode(name, body);
+
+    std::string doc = MakeStringArray(size, body);
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    mj::JsonNode node = mj::ParseFrom(doc);
+    seconds = mj::bench::Measure([&] {
+        std::ostringstream stream;
+        node.SerializeToStream(stream);
+        mj::bench::DoNotOptimize(stream);
+    });
+    mj::bench::Report(name + ": SerializeToStream", doc.size(), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench escapes [size_mb=64]
+MJ_BENCHMARK(escapes, "escape decoding while parsing and escaping while serializing string-heavy documents")
+{
+    size_t size = mj::bench::ArgOr(args, 0, 64) * 1024 * 1024;
+    Compare("dense escapes", size, 8);
+    Compare("sparse escapes", size, 500);
+    Compare("long runs", size, 4096);
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,52 @@
+#include "events.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Sums up every number, the way a column writer would consume them
+struct NumberSum
+{
+    bool StartObject() { return true; }
+    bool Key(std::string_view) { return true; }
+    bool EndObject(size_t) { return true; }
+    bool StartArray() { return true; }
+    bool EndArray(size_t) { return true; }
+    bool String(std::string_view) { return true; }
+    bool Number(mj::JsonNumber number) { sum += number; return true; }
+    bool Bool(bool) { return true; }
+    bool Null() { return true; }
+
+    double sum = 0.0;
+};
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench events [size_mb=64]
+MJ_BENCHMARK(events, "ParseEvents against ParseFrom on the same document")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        NumberSum handler;
+        mj::ParseEvents(doc, handler);
+        mj::bench::DoNotOptimize(handler.sum);
+    });
+    mj::bench::Report("ParseEvents", doc.size(), seconds);
+    return 0;
+}
+
+// =============================================================================
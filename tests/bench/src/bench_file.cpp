@@ -0,0 +1,60 @@
+#include <filesystem>
+#include <fstream>
+
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    std::string content;
+    content.resize(std::filesystem::file_size(path));
+    stream.read(content.data(), static_cast<std::streamsize>(content.size()));
+    return content;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench file [size_mb=128] [path=<temp dir>/myjson-bench-file.json]
+//
+// NOTE: the file is written right before the runs, so both paths read it from
+// the page cache. Drop the cache by hand between runs to compare cold reads:
+//   sync; echo 3 > /proc/sys/vm/drop_caches
+MJ_BENCHMARK(file, "ParseFile against reading the file into a string and ParseFrom")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 128);
+    std::filesystem::path path = args.size() > 1 ? std::filesystem::path(args[1])
+                                                 : std::filesystem::temp_directory_path() / "myjson-bench-file.json";
+
+    {
+        std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+        std::ofstream(path, std::ios::binary) << doc;
+    }
+    size_t size = std::filesystem::file_size(path);
+
+    double seconds = mj::bench::Measure([&] {
+        std::string content = ReadFile(path);
+        mj::JsonNode node = mj::ParseFrom(content);
+        mj::bench::DoNotOptimize(node);
+    }, 3);
+    mj::bench::Report("read + ParseFrom", size, seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFile(path);
+        mj::bench::DoNotOptimize(node);
+    }, 3);
+    mj::bench::Report("ParseFile", size, seconds);
+
+    std::filesystem::remove(path);
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,76 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compact.hpp"
+#include "parser.hpp"
+#include "thread_pool.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+constexpr size_t SETTINGS = 200;
+
+// Settings with a few fields each
+std::string MakeConfig()
+{
+    std::string result = "{";
+    for (size_t i = 0; i < SETTINGS; i++)
+    {
+        result += (i > 0 ? ", \"setting." : "\"setting.") + std::to_string(i) + "\": ";
+        result += "{\"value\": " + std::to_string(i) + ", \"enabled\": true, \"owner\": \"team\"}";
+    }
+    result += "}";
+    return result;
+}
+
+// =============================================================================
+
+template<typename Lookup>
+void Run(const std::string& name, mj::ThreadPool& pool, size_t lookups, const std::vector<std::string>& keys, Lookup lookup)
+{
+    size_t per_task = lookups / pool.Size();
+    double seconds = mj::bench::Measure([&] {
+        pool.Run(pool.Size(), [&](size_t task) {
+            int64_t sum = 0;
+            for (size_t i = 0; i < per_task; i++)
+                sum += lookup(keys[(i * 31 + task) % keys.size()]);
+            mj::bench::DoNotOptimize(sum);
+        });
+    });
+    mj::bench::Report(name, per_task * pool.Size() * sizeof(int64_t), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench freeze [lookups=20000000] [threads=hardware_concurrency]
+MJ_BENCHMARK(freeze, "concurrent config lookups in a JsonNode tree and in its Freeze() copy")
+{
+    size_t lookups = mj::bench::ArgOr(args, 0, 20000000);
+    size_t threads = mj::bench::ArgOr(args, 1, std::thread::hardware_concurrency());
+    mj::ThreadPool pool{threads};
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < SETTINGS; i++)
+        keys.push_back("setting." + std::to_string(i));
+
+    mj::JsonNode node = mj::ParseFrom(MakeConfig());
+    mj::CompactDocument frozen = mj::Freeze(node);
+    std::string prefix = std::to_string(threads) + " threads: ";
+
+    Run(prefix + "JsonNode", pool, lookups, keys, [&](const std::string& key) {
+        return node.AsObject()[key].AsObject()["value"].AsNumber().To<int64_t>();
+    });
+    Run(prefix + "Freeze()", pool, lookups, keys, [&](const std::string& key) {
+        return frozen.Root()[key]["value"].AsNumber().To<int64_t>();
+    });
+    return 0;
+}
+
+// =============================================================================
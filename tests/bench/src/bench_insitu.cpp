@@ -0,0 +1,67 @@
+#include <cstring>
+#include <random>
+
+#include "parser.hpp"
+#include "view.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Records made of short strings only, like log lines or catalog entries
+std::string MakeStringArray(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+
+    std::string result = "[";
+    result.reserve(bytes + 256);
+    for (size_t i = 0; result.size() < bytes; i++)
+    {
+        if (i > 0)
+            result += ",\n  ";
+        result += "{\"level\": \"info\", \"host\": \"host-" + std::to_string(rng() % 100) + "\"" +
+                  ", \"service\": \"billing\", \"trace\": \"" + std::to_string(rng()) + "\"" +
+                  ", \"message\": \"request \\\"" + std::to_string(i) + "\\\" served\\n\"}";
+    }
+    result += "]";
+    return result;
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& doc)
+{
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    // NOTE: the copy into the scratch buffer is part of the measured time,
+    // every run needs the original text back
+    std::vector<char> buffer(doc.size());
+    seconds = mj::bench::Measure([&] {
+        std::memcpy(buffer.data(), doc.data(), doc.size());
+        mj::ViewNode node = mj::ParseInSitu(buffer);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseInSitu", doc.size(), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench insitu [size_mb=64]
+MJ_BENCHMARK(insitu, "ParseInSitu against ParseFrom on string-heavy and mixed documents")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    Compare("strings", MakeStringArray(size_mb * 1024 * 1024));
+    Compare("mixed", mj::bench::MakeMixedArray(size_mb * 1024 * 1024));
+    return 0;
+}
+
+// =============================================================================
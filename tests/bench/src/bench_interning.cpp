@@ -0,0 +1,120 @@
+#include <malloc.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "compact.hpp"
+#include "key_interner.hpp"
+#include "thread_pool.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+constexpr size_t KEY_COUNT = 40;
+
+// Log record with the same 40 keys every time, some longer than fit inline
+std::string MakeRecord(size_t i)
+{
+    std::string record = "{";
+    for (size_t key = 0; key < KEY_COUNT; key++)
+    {
+        if (key > 0)
+            record += ", ";
+        record += key % 2 ? "\"request_attribute_" : "\"field_";
+        record += std::to_string(key) + "\": " + std::to_string(i * KEY_COUNT + key);
+    }
+    record += "}";
+    return record;
+}
+
+// =============================================================================
+
+size_t HeapInUse()
+{
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// =============================================================================
+
+void Run(const std::string& name, const std::vector<std::string>& records, mj::ThreadPool& pool,
+         const mj::JsonDeserializeOptions& options)
+{
+    size_t bytes = 0;
+    for (const std::string& record: records)
+        bytes += record.size();
+
+    std::vector<mj::CompactDocument> documents;
+    documents.reserve(records.size());
+    size_t before = HeapInUse();
+    for (const std::string& record: records)
+        documents.emplace_back(record, options);
+    std::cout << name << ": " << (HeapInUse() - before) / records.size() << " bytes per document" << std::endl;
+
+    double seconds = mj::bench::Measure([&] {
+        pool.Run(records.size(), [&](size_t i) {
+            mj::CompactDocument document{records[i], options};
+            mj::bench::DoNotOptimize(document);
+        });
+    });
+    mj::bench::Report(name + ": parse on " + std::to_string(pool.Size()) + " threads", bytes, seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench interning [records=200000] [threads=hardware_concurrency]
+MJ_BENCHMARK(interning, "CompactDocument with and without a shared KeyInterner on repeated-schema records")
+{
+    size_t count = mj::bench::ArgOr(args, 0, 200000);
+    size_t threads = mj::bench::ArgOr(args, 1, std::thread::hardware_concurrency());
+    mj::ThreadPool pool{threads};
+
+    std::vector<std::string> records;
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        records.push_back(MakeRecord(i));
+        bytes += records.back().size();
+    }
+
+    mj::KeyInterner interner;
+    Run("plain keys", records, pool, {});
+    Run("interned keys", records, pool, mj::JsonDeserializeOptions{.key_interner = &interner});
+
+    // Lookups of the last field: string compares against pointer compares
+    std::vector<mj::CompactDocument> plain;
+    std::vector<mj::CompactDocument> interned;
+    for (const std::string& record: records)
+    {
+        plain.emplace_back(record);
+        interned.emplace_back(record, mj::JsonDeserializeOptions{.key_interner = &interner});
+    }
+
+    std::string_view last = "request_attribute_39";
+    double seconds = mj::bench::Measure([&] {
+        int64_t sum = 0;
+        for (const mj::CompactDocument& document: plain)
+            sum += document.Root()[last].AsNumber().To<int64_t>();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("lookup by string", bytes, seconds);
+
+    mj::InternedKey key = interner.Intern(last);
+    seconds = mj::bench::Measure([&] {
+        int64_t sum = 0;
+        for (const mj::CompactDocument& document: interned)
+            sum += document.Root()[key].AsNumber().To<int64_t>();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("lookup by InternedKey", bytes, seconds);
+    return 0;
+}
+
+// =============================================================================
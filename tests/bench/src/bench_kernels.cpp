@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <iostream>
+
+#include "detail/simd.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+using mj::detail::SimdLevel;
+
+// =============================================================================
+
+// Runs `kernel` over `str` token by token, the way the parser calls it
+template<typename Kernel>
+void RunKernel(const char* name, const std::string& str, size_t token_size, Kernel kernel)
+{
+    for (auto level: {SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2})
+    {
+        if (level > mj::detail::DetectSimdLevel())
+            continue;
+
+        double seconds = mj::bench::Measure([&] {
+            size_t pos = 0;
+            while (pos < str.size())
+                pos = kernel(str, pos, level) + 1;
+            mj::bench::DoNotOptimize(pos);
+        }, 10);
+
+        mj::bench::Report(std::string(name) + " " + std::to_string(token_size) + "B " +
+                          std::string(mj::detail::ToString(level)), str.size(), seconds);
+    }
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench kernels [size_mb=16]
+MJ_BENCHMARK(kernels, "string, whitespace and copy kernels for every supported SIMD level")
+{
+    size_t size = mj::bench::ArgOr(args, 0, 16) * 1024 * 1024;
+
+    for (size_t token_size: {8, 32, 128, 1024})
+    {
+        std::string strings;
+        std::string spaces;
+        while (strings.size() < size)
+        {
+            strings += std::string(token_size, 'a') + '"';
+            spaces += std::string(token_size, ' ') + 'x';
+        }
+
+        RunKernel("quote", strings, token_size, [](std::string_view s, size_t pos, SimdLevel level) {
+            return mj::detail::FindQuoteOrBackslash(s, pos, level);
+        });
+        RunKernel("whitespace", spaces, token_size, [](std::string_view s, size_t pos, SimdLevel level) {
+            return mj::detail::SkipWhitespaces(s, pos, level);
+        });
+
+        std::string escaped = strings;
+        std::replace(escaped.begin(), escaped.end(), '"', '\\');
+        std::string out(escaped.size(), '\0');
+        RunKernel("copy", escaped, token_size, [&](std::string_view s, size_t pos, SimdLevel level) {
+            return mj::detail::CopyUntilBackslash(s, pos, out.data() + pos, level);
+        });
+    }
+    return 0;
+}
+
+// =============================================================================
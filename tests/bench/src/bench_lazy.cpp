@@ -0,0 +1,56 @@
+#include "lazy.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// About 10 KB request body: a few flat fields followed by bulky payload
+std::string MakeRequestBody()
+{
+    std::string body = "{\"user\": {\"id\": 12345, \"name\": \"alice\"}, \"action\": \"update\", \"payload\": ";
+    body += mj::bench::MakeMixedArray(10 * 1024);
+    body += ", \"trace_id\": \"0af7651916cd43dd8448eb211c80319c\"}";
+    return body;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench lazy [iterations=20000]
+MJ_BENCHMARK(lazy, "reading 3 fields of a 10 KB body with LazyDocument and ParseFrom")
+{
+    size_t iterations = mj::bench::ArgOr(args, 0, 20000);
+    std::string body = MakeRequestBody();
+
+    double seconds = mj::bench::Measure([&] {
+        for (size_t i = 0; i < iterations; i++)
+        {
+            mj::JsonNode node = mj::ParseFrom(body);
+            auto& object = node.AsObject();
+            mj::bench::DoNotOptimize(object["user"].AsObject()["id"].AsNumber());
+            mj::bench::DoNotOptimize(object["action"].AsString());
+            mj::bench::DoNotOptimize(object["trace_id"].AsString());
+        }
+    });
+    mj::bench::Report("ParseFrom", body.size() * iterations, seconds);
+
+    seconds = mj::bench::Measure([&] {
+        for (size_t i = 0; i < iterations; i++)
+        {
+            mj::LazyDocument doc{body};
+            auto object = doc.AsObject();
+            mj::bench::DoNotOptimize(object["user"].AsObject()["id"].AsNumber());
+            mj::bench::DoNotOptimize(object["action"].AsString());
+            mj::bench::DoNotOptimize(object["trace_id"].AsString());
+        }
+    });
+    mj::bench::Report("LazyDocument", body.size() * iterations, seconds);
+    return 0;
+}
+
+// =============================================================================
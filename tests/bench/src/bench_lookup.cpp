@@ -0,0 +1,97 @@
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "json.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Keys as they come from a request: views into a buffer, not std::strings
+std::vector<std::string_view> MakeQueries(const std::string& buffer, size_t count)
+{
+    std::vector<size_t> starts;
+    for (size_t pos = 0; pos < buffer.size(); pos = buffer.find(' ', pos) + 1)
+        starts.push_back(pos);
+
+    std::mt19937_64 rng(42);
+    std::vector<std::string_view> queries;
+    queries.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t start = starts[rng() % starts.size()];
+        queries.push_back(std::string_view(buffer).substr(start, buffer.find(' ', start) - start));
+    }
+    return queries;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench lookup [entries=10000] [lookups=10000000]
+MJ_BENCHMARK(lookup, "string_view lookups in a big JsonObject against std::unordered_map<std::string, JsonNode>")
+{
+    size_t entries = mj::bench::ArgOr(args, 0, 10000);
+    size_t lookups = mj::bench::ArgOr(args, 1, 10000000);
+
+    std::string buffer;
+    mj::JsonObject object;
+    std::unordered_map<std::string, mj::JsonNode> map;
+    for (size_t i = 0; i < entries; i++)
+    {
+        std::string key = "product/" + std::to_string(i * 7919);
+        buffer += key + " ";
+        object.AddField(key, static_cast<int64_t>(i));
+        map.emplace(key, static_cast<int64_t>(i));
+    }
+    // NOTE: a quarter of the queries miss
+    for (size_t i = 0; i < entries / 3; i++)
+        buffer += "missing/" + std::to_string(i) + " ";
+    std::vector<std::string_view> queries = MakeQueries(buffer, lookups);
+
+    // The interface JsonObject had on top of the map: Has() and Get() take a
+    // const std::string&, and Get() checks the key before finding it
+    double seconds = mj::bench::Measure([&] {
+        int64_t sum = 0;
+        for (std::string_view query: queries)
+        {
+            std::string key{query};
+            if (map.contains(key) && map.contains(key))
+                sum += map.find(key)->second.AsNumber().To<int64_t>();
+        }
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("unordered_map: Has + Get", lookups * sizeof(std::string_view), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        int64_t sum = 0;
+        for (std::string_view query: queries)
+        {
+            auto it = map.find(std::string{query});
+            if (it != map.end())
+                sum += it->second.AsNumber().To<int64_t>();
+        }
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("unordered_map: find", lookups * sizeof(std::string_view), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        int64_t sum = 0;
+        for (std::string_view query: queries)
+        {
+            if (object.Has(query))
+                sum += object.Get(query).AsNumber().To<int64_t>();
+        }
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("JsonObject: Has + Get", lookups * sizeof(std::string_view), seconds);
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <random>
+
+#include "parallel.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+std::string MakeNdjson(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+
+    std::string result;
+    result.reserve(bytes + 256);
+    for (size_t i = 0; result.size() < bytes; i++)
+    {
+        result += "{\"id\": " + std::to_string(rng() % 1000000) +
+                  ", \"name\": \"user_" + std::to_string(i) + "\"" +
+                  ", \"score\": " + std::to_string(static_cast<double>(rng() % 100000) / 100.0) +
+                  ", \"tags\": [\"alpha\", \"beta\", null], \"active\": true}\n";
+    }
+    return result;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench ndjson [size_mb=256] [max_threads=hardware_concurrency]
+MJ_BENCHMARK(ndjson, "ParseNdjson throughput for a growing number of threads")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 256);
+    size_t max_threads = mj::bench::ArgOr(args, 1, std::max(1u, std::thread::hardware_concurrency()));
+    std::string doc = MakeNdjson(size_mb * 1024 * 1024);
+
+    // Powers of two, then the requested maximum
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(max_threads);
+
+    double base_seconds = 0.0;
+    for (size_t threads: thread_counts)
+    {
+        mj::ThreadPool pool{threads};
+        double seconds = mj::bench::Measure([&] {
+            std::vector<mj::JsonNode> nodes = mj::ParseNdjson(doc, pool);
+            mj::bench::DoNotOptimize(nodes);
+        }, 3);
+
+        if (threads == thread_counts.front())
+            base_seconds = seconds;
+        mj::bench::Report("threads " + std::to_string(threads), doc.size(), seconds);
+        std::cout << "    speedup " << base_seconds / seconds << "x" << std::endl;
+    }
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,155 @@
+#include <charconv>
+#include <random>
+#include <sstream>
+
+#include "detail/number.hpp"
+#include "events.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Polygon coordinates printed with 17 significant digits, like canada.json
+std::string MakeCoordinates(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> lon(-141.0, -52.0);
+    std::uniform_real_distribution<double> lat(41.0, 83.0);
+
+    char buffer[32];
+    auto append = [&](std::string& str, double value) {
+        str.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 15).ptr);
+    };
+
+    std::string result = "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": \"Feature\", "
+                         "\"geometry\": {\"type\": \"Polygon\", \"coordinates\": [[";
+    result.reserve(bytes + 256);
+    while (result.size() < bytes)
+    {
+        if (result.back() != '[')
+            result += ",";
+        result += '[';
+        append(result, lon(rng));
+        result += ',';
+        append(result, lat(rng));
+        result += ']';
+    }
+    result += "]]}}]}";
+    return result;
+}
+
+// =============================================================================
+
+std::string MakeIntegers(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+
+    std::string result = "[";
+    result.reserve(bytes + 32);
+    while (result.size() < bytes)
+    {
+        if (result.size() > 1)
+            result += ',';
+        result += std::to_string(rng() % 1000000000);
+    }
+    result += ']';
+    return result;
+}
+
+// =============================================================================
+
+struct NullHandler
+{
+    bool StartObject() { return true; }
+    bool Key(std::string_view) { return true; }
+    bool EndObject(size_t) { return true; }
+    bool StartArray() { return true; }
+    bool EndArray(size_t) { return true; }
+    bool String(std::string_view) { return true; }
+    bool Number(mj::JsonNumber) { return true; }
+    bool Bool(bool) { return true; }
+    bool Null() { return true; }
+};
+
+// =============================================================================
+
+// Conversion alone: every number of `doc` is converted by `convert`, which
+// returns the end of the number, or its start if there is none
+template<typename Convert>
+void RunConversion(const std::string& name, const std::string& doc, Convert convert)
+{
+    double seconds = mj::bench::Measure([&] {
+        const char* p = doc.data();
+        const char* end = p + doc.size();
+        double sum = 0.0;
+        while (p != end)
+        {
+            if (!mj::detail::IsDigit(*p) && *p != '-')
+            {
+                p++;
+                continue;
+            }
+            // NOTE: a failed conversion leaves `value` alone, and a lone `-`
+            // must still be stepped over
+            double value = 0.0;
+            const char* next = convert(p, end, value);
+            p = next == p ? p + 1 : next;
+            sum += value;
+        }
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report(name, doc.size(), seconds);
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& doc)
+{
+    RunConversion(name + ": std::from_chars", doc, [](const char* first, const char* last, double& value) {
+        return std::from_chars(first, last, value).ptr;
+    });
+    RunConversion(name + ": ParseDouble", doc, [](const char* first, const char* last, double& value) {
+        const char* end = mj::detail::ParseDouble(first, last, value);
+        return end != nullptr ? end : first;
+    });
+
+    double seconds = mj::bench::Measure([&] {
+        NullHandler handler;
+        mj::ParseEvents(doc, handler);
+    });
+    mj::bench::Report(name + ": ParseEvents", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    mj::JsonNode node = mj::ParseFrom(doc);
+    seconds = mj::bench::Measure([&] {
+        std::ostringstream stream;
+        node.SerializeToStream(stream);
+        mj::bench::DoNotOptimize(stream);
+    });
+    mj::bench::Report(name + ": SerializeToStream", doc.size(), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench numbers [size_mb=64]
+MJ_BENCHMARK(numbers, "number conversion, parsing and serialization of number-heavy documents")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    Compare("coordinates", MakeCoordinates(size_mb * 1024 * 1024));
+    Compare("integers", MakeIntegers(size_mb * 1024 * 1024));
+    Compare("random", mj::bench::MakeNumberArray(size_mb * 1024 * 1024));
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,72 @@
+#include <sstream>
+#include <string>
+
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+std::string MakeWideObject(size_t fields)
+{
+    std::string result = "{";
+    for (size_t i = 0; i < fields; i++)
+        result += (i > 0 ? ", \"field_" : "\"field_") + std::to_string(i) + "\": " + std::to_string(i);
+    result += "}";
+    return result;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench objects [size_mb=64]
+MJ_BENCHMARK(objects, "building, looking up and serializing small and wide JsonObjects")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("small objects: parse", doc.size(), seconds);
+
+    mj::JsonNode node = mj::ParseFrom(doc);
+    seconds = mj::bench::Measure([&] {
+        double sum = 0.0;
+        for (const mj::JsonNode& record: node.AsArray())
+            sum += record.AsObject()["score"].AsNumber() + record.AsObject()["id"].AsNumber();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("small objects: 2 lookups each", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        std::ostringstream stream;
+        node.SerializeToStream(stream);
+        mj::bench::DoNotOptimize(stream);
+    });
+    mj::bench::Report("small objects: serialize", doc.size(), seconds);
+
+    std::string wide = MakeWideObject(100000);
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode parsed = mj::ParseFrom(wide);
+        mj::bench::DoNotOptimize(parsed);
+    });
+    mj::bench::Report("wide object: parse", wide.size(), seconds);
+
+    mj::JsonNode wide_node = mj::ParseFrom(wide);
+    seconds = mj::bench::Measure([&] {
+        double sum = 0.0;
+        for (size_t i = 0; i < 100000; i += 7)
+            sum += wide_node.AsObject()["field_" + std::to_string(i)].AsNumber();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("wide object: lookups", wide.size(), seconds);
+    return 0;
+}
+
+// =============================================================================
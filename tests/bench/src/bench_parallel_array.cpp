@@ -0,0 +1,39 @@
+#include <iostream>
+
+#include "parallel.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+// Usage: myjson-bench parallel_array [size_mb=256] [max_threads=hardware_concurrency]
+MJ_BENCHMARK(parallel_array, "ParseArrayParallel against ParseFrom on one big array")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 256);
+    size_t max_threads = mj::bench::ArgOr(args, 1, std::max(1u, std::thread::hardware_concurrency()));
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    double base_seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    }, 3);
+    mj::bench::Report("ParseFrom", doc.size(), base_seconds);
+
+    for (size_t threads = 2; threads < 2 * max_threads; threads *= 2)
+    {
+        threads = std::min(threads, max_threads);
+
+        mj::ThreadPool pool{threads};
+        double seconds = mj::bench::Measure([&] {
+            mj::JsonNode node = mj::ParseArrayParallel(doc, pool);
+            mj::bench::DoNotOptimize(node);
+        }, 3);
+
+        mj::bench::Report("ParseArrayParallel, threads " + std::to_string(threads), doc.size(), seconds);
+        std::cout << "    speedup " << base_seconds / seconds << "x" << std::endl;
+    }
+    return 0;
+}
+
+// =============================================================================
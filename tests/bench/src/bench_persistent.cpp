@@ -0,0 +1,70 @@
+#include <sstream>
+#include <string>
+
+#include "parser.hpp"
+#include "persistent.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Config of `sections` sections of 100 entries each
+std::string MakeConfig(size_t sections)
+{
+    std::string result = "{";
+    for (size_t s = 0; s < sections; s++)
+    {
+        result += (s > 0 ? ", \"section_" : "\"section_") + std::to_string(s) + "\": {";
+        for (size_t e = 0; e < 100; e++)
+        {
+            result += (e > 0 ? ", \"entry_" : "\"entry_") + std::to_string(e) + "\": ";
+            result += "{\"value\": " + std::to_string(s * e) + ", \"enabled\": true, \"tags\": [\"x\", \"y\"]}";
+        }
+        result += "}";
+    }
+    result += "}";
+    return result;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench persistent [sections=100] [changes=1000]
+MJ_BENCHMARK(persistent, "modified copies of a config: reserialize and reparse against PersistentNode::SetIn")
+{
+    size_t sections = mj::bench::ArgOr(args, 0, 100);
+    size_t changes = mj::bench::ArgOr(args, 1, 1000);
+    std::string text = MakeConfig(sections);
+
+    mj::JsonNode node = mj::ParseFrom(text);
+    double seconds = mj::bench::Measure([&] {
+        for (size_t i = 0; i < changes / 100 + 1; i++)
+        {
+            std::ostringstream stream;
+            node.SerializeToStream(stream);
+            mj::JsonNode copy = mj::ParseFrom(stream.str());
+            copy.AsObject()["section_1"].AsObject()["entry_2"].AsObject()["value"] = mj::JsonNode{static_cast<int64_t>(i)};
+            mj::bench::DoNotOptimize(copy);
+        }
+    });
+    mj::bench::Report("reserialize + reparse (per change)", text.size(), seconds / static_cast<double>(changes / 100 + 1));
+
+    mj::PersistentNode root{node};
+    seconds = mj::bench::Measure([&] {
+        mj::PersistentNode version = root;
+        for (size_t i = 0; i < changes; i++)
+        {
+            std::string section = "section_" + std::to_string(i % sections);
+            version = version.SetIn({section, "entry_2", "value"}, static_cast<int64_t>(i));
+        }
+        mj::bench::DoNotOptimize(version);
+    });
+    mj::bench::Report("PersistentNode::SetIn (per change)", text.size(), seconds / static_cast<double>(changes));
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,32 @@
+#include "parser.hpp"
+#include "push_parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+// Usage: myjson-bench push [size_mb=64] [chunk_kb=16]
+MJ_BENCHMARK(push, "PushParser fed in fixed-size chunks against ParseFrom")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    size_t chunk_size = mj::bench::ArgOr(args, 1, 16) * 1024;
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::PushParser parser;
+        for (size_t pos = 0; pos < doc.size(); pos += chunk_size)
+            parser.Feed(std::string_view{doc}.substr(pos, chunk_size));
+        mj::JsonNode node = parser.Finish();
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("PushParser", doc.size(), seconds);
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,57 @@
+#include <sstream>
+
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Proxy path: parse, pass through, serialize
+void RoundTrip(const std::string& name, const std::string& doc, const mj::JsonDeserializeOptions& options)
+{
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc, options);
+        std::ostringstream stream;
+        node.SerializeToStream(stream);
+        mj::bench::DoNotOptimize(stream);
+    });
+    mj::bench::Report(name, doc.size(), seconds);
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& doc)
+{
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc, mj::JsonDeserializeOptions{.raw_numbers = true});
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom raw", doc.size(), seconds);
+
+    RoundTrip(name + ": round trip", doc, {});
+    RoundTrip(name + ": round trip raw", doc, mj::JsonDeserializeOptions{.raw_numbers = true});
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench raw_numbers [size_mb=64]
+MJ_BENCHMARK(raw_numbers, "parsing and pass-through with and without JsonDeserializeOptions::raw_numbers")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    Compare("numbers", mj::bench::MakeNumberArray(size_mb * 1024 * 1024));
+    Compare("mixed", mj::bench::MakeMixedArray(size_mb * 1024 * 1024));
+    return 0;
+}
+
+// =============================================================================
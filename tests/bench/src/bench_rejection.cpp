@@ -0,0 +1,94 @@
+#include <iostream>
+#include <random>
+
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Request bodies as an abused public endpoint sees them: valid records cut
+// short, with a byte overwritten, or with a token misspelled
+std::vector<std::string> MakeMalformedCorpus(size_t count)
+{
+    std::mt19937_64 rng(42);
+    static const char noise[] = "{}[]:,\"\\ x0-.e";
+
+    std::vector<std::string> corpus;
+    corpus.reserve(count);
+    while (corpus.size() < count)
+    {
+        std::string record = "{\"id\": " + std::to_string(rng() % 1000000) +
+                             ", \"name\": \"user_" + std::to_string(rng() % 10000) + "\"" +
+                             ", \"score\": " + std::to_string(static_cast<double>(rng() % 100000) / 100.0) +
+                             ", \"tags\": [\"alpha\", \"beta\", null], \"active\": true}";
+        switch (rng() % 3)
+        {
+        case 0:
+            record.resize(rng() % record.size());
+            break;
+        case 1:
+            record[rng() % record.size()] = noise[rng() % (sizeof(noise) - 1)];
+            break;
+        default:
+            record.replace(record.find("true"), 4, "ture");
+            break;
+        }
+
+        if (!mj::TryParse(record).has_value())
+            corpus.push_back(std::move(record));
+    }
+    return corpus;
+}
+
+// =============================================================================
+
+template<typename Parse>
+void Run(const std::string& name, const std::vector<std::string>& corpus, size_t bytes, Parse parse)
+{
+    size_t rejected = 0;
+    double seconds = mj::bench::Measure([&] {
+        rejected = 0;
+        for (const std::string& record: corpus)
+            rejected += parse(record) ? 0 : 1;
+    });
+    mj::bench::Report(name, bytes, seconds);
+    std::cout << "    " << static_cast<size_t>(rejected / seconds) << " rejections/s" << std::endl;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench rejection [records=1000000]
+MJ_BENCHMARK(rejection, "rejection throughput of malformed documents, exceptions against TryParse")
+{
+    std::vector<std::string> corpus = MakeMalformedCorpus(mj::bench::ArgOr(args, 0, 1000000));
+    size_t bytes = 0;
+    for (const std::string& record: corpus)
+        bytes += record.size();
+
+    Run("ParseFrom + catch", corpus, bytes, [](const std::string& record) {
+        try
+        {
+            mj::JsonNode node = mj::ParseFrom(record);
+            mj::bench::DoNotOptimize(node);
+            return true;
+        }
+        catch (const mj::JsonException&)
+        {
+            return false;
+        }
+    });
+    Run("TryParse", corpus, bytes, [](const std::string& record) {
+        auto result = mj::TryParse(record);
+        mj::bench::DoNotOptimize(result);
+        return result.has_value();
+    });
+    return 0;
+}
+
+// =============================================================================
@@ -0,0 +1,67 @@
+#include <iostream>
+
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Per-byte parse time drifts once the tree no longer fits in caches, but a
+// quadratic parser blows far past this between 1 MB and the largest size
+constexpr double MAX_SLOWDOWN = 4.0;
+
+// =============================================================================
+
+int CheckScaling(const char* name, std::string (*make)(size_t), size_t max_mb)
+{
+    double base_seconds_per_mb = 0.0;
+    double worst_slowdown = 1.0;
+
+    for (size_t mb = 1; mb <= max_mb; mb *= 4)
+    {
+        std::string doc = make(mb * 1024 * 1024);
+        // NOTE: destruction of the tree is left out of the measured time
+        double seconds = 0.0;
+        for (size_t run = 0; run < (mb < 64 ? 5 : 1); run++)
+        {
+            mj::bench::Timer timer;
+            mj::JsonNode node = mj::ParseFrom(doc);
+            double elapsed = timer.Seconds();
+            if (run == 0 || elapsed < seconds)
+                seconds = elapsed;
+        }
+
+        mj::bench::Report(std::string(name) + " " + std::to_string(mb) + "MB", doc.size(), seconds);
+
+        double seconds_per_mb = seconds / static_cast<double>(mb);
+        if (mb == 1)
+            base_seconds_per_mb = seconds_per_mb;
+        else
+            worst_slowdown = std::max(worst_slowdown, seconds_per_mb / base_seconds_per_mb);
+    }
+
+    std::cout << name << ": worst per-MB slowdown " << worst_slowdown << "x" << std::endl;
+    return worst_slowdown <= MAX_SLOWDOWN ? 0 : 1;
+}
+
+// =============================================================================
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench scaling [max_mb=1024]
+MJ_BENCHMARK(scaling, "parse time of 1 MB .. max_mb documents must grow linearly")
+{
+    size_t max_mb = mj::bench::ArgOr(args, 0, 1024);
+
+    int failed = 0;
+    failed += CheckScaling("numbers", mj::bench::MakeNumberArray, max_mb);
+    failed += CheckScaling("mixed", mj::bench::MakeMixedArray, max_mb);
+    return failed;
+}
+
+// =============================================================================
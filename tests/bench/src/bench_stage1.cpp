@@ -0,0 +1,35 @@
+#include "detail/structural_index.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+// Usage: myjson-bench stage1 [size_mb=64]
+MJ_BENCHMARK(stage1, "structural index throughput for every supported SIMD level")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    std::vector<uint32_t> positions;
+    for (auto level: {mj::detail::SimdLevel::Scalar, mj::detail::SimdLevel::Sse42, mj::detail::SimdLevel::Avx2})
+    {
+        if (level > mj::detail::DetectSimdLevel())
+            continue;
+
+        double seconds = mj::bench::Measure([&] {
+            mj::detail::BuildStructuralIndex(doc, positions, level);
+            mj::bench::DoNotOptimize(positions.data());
+        });
+        mj::bench::Report("stage1 " + std::string(mj::detail::ToString(level)), doc.size(), seconds);
+    }
+
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("ParseFrom", doc.size(), seconds);
+    return 0;
+}
+
+// =============================================================================
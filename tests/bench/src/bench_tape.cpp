@@ -0,0 +1,104 @@
+#include "parser.hpp"
+#include "tape.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+// Visits every value and sums up the numbers
+double Walk(const mj::JsonNode& node)
+{
+    if (node.IsNumber())
+        return node.AsNumber();
+
+    double sum = 0.0;
+    if (node.IsArray())
+    {
+        for (const mj::JsonNode& item: node.AsArray())
+            sum += Walk(item);
+    }
+    else if (node.IsObject())
+    {
+        for (const auto& [key, value]: node.AsObject())
+            sum += Walk(value);
+    }
+    return sum;
+}
+
+double Walk(const mj::TapeValue& value)
+{
+    if (value.IsNumber())
+        return value.AsNumber();
+
+    double sum = 0.0;
+    if (value.IsArray())
+    {
+        for (const mj::TapeValue& item: value.AsArray())
+            sum += Walk(item);
+    }
+    else if (value.IsObject())
+    {
+        for (const auto& [key, field]: value.AsObject())
+            sum += Walk(field);
+    }
+    return sum;
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench tape [size_mb=64]
+MJ_BENCHMARK(tape, "parsing into and scanning a TapeDocument against a JsonNode tree")
+{
+    size_t size_mb = mj::bench::ArgOr(args, 0, 64);
+    std::string doc = mj::bench::MakeMixedArray(size_mb * 1024 * 1024);
+
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report("parse: ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::TapeDocument tape{doc};
+        mj::bench::DoNotOptimize(tape);
+    });
+    mj::bench::Report("parse: TapeDocument", doc.size(), seconds);
+
+    mj::JsonNode node = mj::ParseFrom(doc);
+    mj::TapeDocument tape{doc};
+
+    seconds = mj::bench::Measure([&] {
+        mj::bench::DoNotOptimize(Walk(node));
+    });
+    mj::bench::Report("walk: JsonNode", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::bench::DoNotOptimize(Walk(tape.Root()));
+    });
+    mj::bench::Report("walk: TapeDocument", doc.size(), seconds);
+
+    // One field of every record, the rest of each record is jumped over
+    seconds = mj::bench::Measure([&] {
+        double sum = 0.0;
+        for (const mj::JsonNode& record: node.AsArray())
+            sum += record.AsObject()["score"].AsNumber();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("field scan: JsonNode", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        double sum = 0.0;
+        for (const mj::TapeValue& record: tape.AsArray())
+            sum += record.AsObject()["score"].AsNumber();
+        mj::bench::DoNotOptimize(sum);
+    });
+    mj::bench::Report("field scan: TapeDocument", doc.size(), seconds);
+    return 0;
+}
+
+// =============================================================================
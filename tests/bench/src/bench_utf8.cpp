@@ -0,0 +1,96 @@
+#include <random>
+
+#include "detail/simd.hpp"
+#include "parser.hpp"
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace
+{
+
+using mj::detail::SimdLevel;
+
+// =============================================================================
+
+// Text made of words from `alphabet`, a list of UTF-8 characters
+std::string MakeText(size_t bytes, const std::vector<std::string>& alphabet)
+{
+    std::mt19937_64 rng(42);
+
+    std::string result;
+    result.reserve(bytes + 16);
+    while (result.size() < bytes)
+    {
+        result += rng() % 6 ? alphabet[rng() % alphabet.size()] : " ";
+    }
+    return result;
+}
+
+// =============================================================================
+
+// Array of short strings cut from `text` on character boundaries
+std::string MakeStringArray(const std::string& text)
+{
+    std::string result = "[";
+    result.reserve(text.size() + text.size() / 8);
+    for (size_t pos = 0; pos < text.size();)
+    {
+        size_t end = text.find(' ', pos + 40);
+        end = end == std::string::npos ? text.size() : end;
+        if (result.size() > 1)
+            result += ",\n";
+        result += '"';
+        result.append(text, pos, end - pos);
+        result += '"';
+        pos = end;
+    }
+    result += "]";
+    return result;
+}
+
+// =============================================================================
+
+void Compare(const std::string& name, const std::string& text)
+{
+    for (auto level: {SimdLevel::Scalar, SimdLevel::Sse42, SimdLevel::Avx2})
+    {
+        if (level > mj::detail::DetectSimdLevel())
+            continue;
+
+        double seconds = mj::bench::Measure([&] {
+            mj::bench::DoNotOptimize(mj::detail::ValidateUtf8(text, level));
+        }, 10);
+        mj::bench::Report(name + ": ValidateUtf8 " + std::string(mj::detail::ToString(level)), text.size(), seconds);
+    }
+
+    std::string doc = MakeStringArray(text);
+    double seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc);
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom", doc.size(), seconds);
+
+    seconds = mj::bench::Measure([&] {
+        mj::JsonNode node = mj::ParseFrom(doc, mj::JsonDeserializeOptions{.strict = true});
+        mj::bench::DoNotOptimize(node);
+    });
+    mj::bench::Report(name + ": ParseFrom strict", doc.size(), seconds);
+}
+
+} // namespace
+
+// =============================================================================
+
+// Usage: myjson-bench utf8 [size_mb=64]
+MJ_BENCHMARK(utf8, "UTF-8 validation kernels and the cost of strict mode on string-heavy documents")
+{
+    size_t size = mj::bench::ArgOr(args, 0, 64) * 1024 * 1024;
+    Compare("ascii", MakeText(size, {"a", "b", "c", "d", "e", "f", "g", "h"}));
+    Compare("latin", MakeText(size, {"a", "e", "\xC3\xA9", "\xC3\xA8", "\xC3\xBC", "n", "o", "s"}));
+    Compare("cjk", MakeText(size, {"\xE4\xB8\xAD", "\xE6\x96\x87", "\xE5\xAD\x97", "\xF0\x9F\x98\x80"}));
+    return 0;
+}
+
+// =============================================================================
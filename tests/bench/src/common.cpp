@@ -0,0 +1,77 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "bench.hpp"
+
+// =============================================================================
+
+namespace mj::bench
+{
+
+// =============================================================================
+
+void Report(const std::string& name, size_t bytes, double seconds)
+{
+    double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << mb << " MB"
+              << std::setprecision(4) << std::setw(12) << seconds << " s"
+              << std::setprecision(1) << std::setw(12) << mb / seconds << " MB/s" << std::endl;
+}
+
+// =============================================================================
+
+size_t ArgOr(const Args& args, size_t index, size_t fallback)
+{
+    return index < args.size() ? std::stoull(args[index]) : fallback;
+}
+
+// =============================================================================
+
+std::string MakeNumberArray(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+    std::string result = "[";
+    result.reserve(bytes + 64);
+    while (result.size() < bytes)
+    {
+        if (result.size() > 1)
+            result += ',';
+        result += std::to_string(dist(rng));
+    }
+    result += ']';
+    return result;
+}
+
+// =============================================================================
+
+std::string MakeMixedArray(size_t bytes)
+{
+    std::mt19937_64 rng(42);
+
+    std::string result = "[";
+    result.reserve(bytes + 256);
+    for (size_t i = 0; result.size() < bytes; i++)
+    {
+        if (i > 0)
+            result += ",\n  ";
+        result += "{\"id\": " + std::to_string(rng() % 1000000) +
+                  ", \"name\": \"user_" + std::to_string(i) + "\"" +
+                  ", \"active\": " + (rng() % 2 ? "true" : "false") +
+                  ", \"score\": " + std::to_string(static_cast<double>(rng() % 100000) / 100.0) +
+                  ", \"tags\": [\"alpha\", \"beta\", null]" +
+                  ", \"bio\": \"Lorem ipsum dolor sit amet, \\\"consectetur\\\" adipiscing elit\"}";
+    }
+    result += "]";
+    return result;
+}
+
+// =============================================================================
+
+} // namespace mj::bench
+
+// =============================================================================
@@ -0,0 +1,204 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "compact.hpp"
+#include "parser.hpp"
+#include "thread_pool.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class CompactTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(CompactTest);
+
+    CPPUNIT_TEST(TestScalars);
+    CPPUNIT_TEST(TestStrings);
+    CPPUNIT_TEST(TestContainers);
+    CPPUNIT_TEST(TestMaterialize);
+    CPPUNIT_TEST(TestErrors);
+    CPPUNIT_TEST(TestLargeObjects);
+    CPPUNIT_TEST(TestFreeze);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestScalars();
+    void TestStrings();
+    void TestContainers();
+    void TestMaterialize();
+    void TestErrors();
+    void TestLargeObjects();
+    void TestFreeze();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(CompactTest);
+
+// =============================================================================
+
+void CompactTest::TestScalars()
+{
+    CompactDocument document{"[null, true, false, -42, 18446744073709551615, 0.25]"};
+    const CompactNode& root = document.Root();
+
+    CPPUNIT_ASSERT(root[0].IsNull());
+    CPPUNIT_ASSERT_EQUAL(true, root[1].AsBool());
+    CPPUNIT_ASSERT_EQUAL(false, root[2].AsBool());
+
+    CPPUNIT_ASSERT(root[3].GetType() == CompactNode::Type::Int64);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-42), root[3].AsNumber().To<int64_t>());
+    CPPUNIT_ASSERT(root[4].GetType() == CompactNode::Type::UInt64);
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(), root[4].AsNumber().To<uint64_t>());
+    CPPUNIT_ASSERT(root[5].GetType() == CompactNode::Type::Double);
+    CPPUNIT_ASSERT(AlmostEqual(0.25, root[5].AsNumber()));
+
+    CompactDocument scalar{" 7 ", JsonDeserializeOptions{.raw_numbers = true}};
+    CPPUNIT_ASSERT_EQUAL(7, scalar.Root().AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void CompactTest::TestStrings()
+{
+    // Up to 14 bytes fit into the node, longer strings go to the arena
+    std::string input = R"(["", "short", "fourteen bytes", "fifteen bytes!!", "escaped \"é\" and long enough"])";
+    CompactDocument document{input};
+    input.assign(input.size(), ' ');
+
+    const CompactNode& root = document.Root();
+    CPPUNIT_ASSERT_EQUAL(std::string_view(""), root[0].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("short"), root[1].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("fourteen bytes"), root[2].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("fifteen bytes!!"), root[3].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("escaped \"\xC3\xA9\" and long enough"), root[4].AsString());
+}
+
+// =============================================================================
+
+void CompactTest::TestContainers()
+{
+    CompactDocument document{R"({"a": {"b": [1, [], {}]}, "a rather long key": "x"})"};
+    const CompactNode& root = document.Root();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), root.Size());
+    CPPUNIT_ASSERT(root.Has("a rather long key"));
+    CPPUNIT_ASSERT(!root.Has("b"));
+    CPPUNIT_ASSERT_EQUAL(std::string_view("x"), root["a rather long key"].AsString());
+
+    const CompactNode& list = root["a"]["b"];
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), list.Size());
+    CPPUNIT_ASSERT_EQUAL(1, list.At(0).AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), list[1].Size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), list[2].Size());
+
+    std::string keys;
+    for (const CompactField& field: root.AsObject())
+        keys += std::string{field.Key()} + ";";
+    CPPUNIT_ASSERT_EQUAL(std::string("a;a rather long key;"), keys);
+}
+
+// =============================================================================
+
+void CompactTest::TestMaterialize()
+{
+    std::string input = R"({"text": "line\nbreak", "numbers": [1, 2.5, -3], "nested": {"ok": true, "none": null}})";
+    JsonNode node = CompactDocument{input}.Root().Materialize();
+
+    JsonObject& object = node.AsObject();
+    CPPUNIT_ASSERT_EQUAL(std::string("line\nbreak"), object["text"].AsString());
+    CPPUNIT_ASSERT_EQUAL(-3, object["numbers"].AsArray()[2].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(true, object["nested"].AsObject()["ok"].AsBool());
+    CPPUNIT_ASSERT(object["nested"].AsObject()["none"].IsNull());
+}
+
+// =============================================================================
+
+void CompactTest::TestErrors()
+{
+    for (std::string bad: {"", "[1, 2", "{\"a\" 1}", R"("\x")", R"("\ud83d")"})
+        CPPUNIT_ASSERT_THROW(CompactDocument{bad}, JsonException);
+    CPPUNIT_ASSERT_THROW(CompactDocument("[[[1]]]", JsonDeserializeOptions{.max_depth = 2}), JsonException);
+
+    CompactDocument document{"[\"text\", 1]"};
+    const CompactNode& root = document.Root();
+    CPPUNIT_ASSERT_THROW(root.At(2), JsonException);
+    CPPUNIT_ASSERT_THROW(root["key"], JsonException);
+    CPPUNIT_ASSERT_THROW(root[0].AsNumber(), JsonException);
+    CPPUNIT_ASSERT_THROW(root[1].AsString(), JsonException);
+    CPPUNIT_ASSERT_THROW(root[1].Size(), JsonException);
+}
+
+// =============================================================================
+
+void CompactTest::TestLargeObjects()
+{
+    // Past 8 fields lookups go through the index; the first duplicate wins
+    std::string input = "{";
+    for (int i = 0; i < 500; i++)
+        input += "\"key" + std::to_string(i) + "\": " + std::to_string(i) + ", ";
+    input += "\"key7\": -1}";
+    CompactDocument document{input};
+    const CompactNode& root = document.Root();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(501), root.Size());
+    for (int i = 0; i < 500; i++)
+        CPPUNIT_ASSERT_EQUAL(i, root["key" + std::to_string(i)].AsNumber().To<int>());
+    CPPUNIT_ASSERT(!root.Has("key500"));
+    CPPUNIT_ASSERT(!root.Has(""));
+
+    int expected = 0;
+    for (const CompactField& field: root.AsObject().first(500))
+        CPPUNIT_ASSERT_EQUAL(expected++, field.Value().AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void CompactTest::TestFreeze()
+{
+    JsonNode node = ParseFrom(R"({"name": "service", "limits": {"a": 1, "b": 2, "c": 3, "d": 4, "e": 5, "f": 6, "g": 7, "h": 8, "i": 9},
+                                  "hosts": ["a", "a rather long host name"], "big": 123456789012345678901234567890, "none": null})",
+                              JsonDeserializeOptions{.raw_numbers = true});
+    CompactDocument frozen = Freeze(node);
+    node = JsonNode{};
+
+    const CompactNode& root = frozen.Root();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("service"), root["name"].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("a rather long host name"), root["hosts"][1].AsString());
+    CPPUNIT_ASSERT(AlmostEqual(1.2345678901234568e29, root["big"].AsNumber()));
+    CPPUNIT_ASSERT(root["none"].IsNull());
+
+    std::string keys;
+    for (const CompactField& field: root.AsObject())
+        keys += std::string{field.Key()} + ";";
+    CPPUNIT_ASSERT_EQUAL(std::string("name;limits;hosts;big;none;"), keys);
+
+    // Readers need no synchronization
+    ThreadPool pool{4};
+    std::vector<int> sums(64);
+    pool.Run(sums.size(), [&](size_t task) {
+        for (int repeat = 0; repeat < 100; repeat++)
+        {
+            for (char key = 'a'; key <= 'i'; key++)
+                sums[task] += root["limits"][std::string_view(&key, 1)].AsNumber().To<int>();
+        }
+    });
+    for (int sum: sums)
+        CPPUNIT_ASSERT_EQUAL(4500, sum);
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -25,6 +25,9 @@ class CompositeTypesTest : public CppUnit::TestFixture
 
     CPPUNIT_TEST(TestConstructArray);
     CPPUNIT_TEST(TestConstructObject);
+    CPPUNIT_TEST(TestObjectOrder);
+    CPPUNIT_TEST(TestLargeObject);
+    CPPUNIT_TEST(TestLookupByView);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -34,6 +37,9 @@ protected:
 
     void TestConstructArray();
     void TestConstructObject();
+    void TestObjectOrder();
+    void TestLargeObject();
+    void TestLookupByView();
 };
 
 // =============================================================================
@@ -207,6 +213,78 @@ void CompositeTypesTest::TestConstructObject()
 
 // =============================================================================
 
+void CompositeTypesTest::TestObjectOrder()
+{
+    JsonObject object{
+        std::make_pair("b", 1),
+        std::make_pair("a", 2),
+        std::make_pair("b", 3),
+    };
+    object.AddField("c", 4);
+    object.AddField("a", 5);
+
+    std::string keys;
+    for (const auto& [key, value]: object)
+        keys += key + std::to_string(value.AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(std::string("b1a2c4"), keys);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), object.Size());
+
+    const JsonObject& const_object = object;
+    CPPUNIT_ASSERT_EQUAL(2, const_object.Get("a").AsNumber().To<int>());
+    CPPUNIT_ASSERT_THROW(const_object.Get("d"), JsonException);
+}
+
+// =============================================================================
+
+void CompositeTypesTest::TestLargeObject()
+{
+    // Past the linear-scan threshold lookups go through the hash index
+    JsonObject object;
+    for (int i = 0; i < 1000; i++)
+        object.AddField("key" + std::to_string(i), i);
+    object.AddField("key7", -1);
+    object.AddField("key500", -1);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1000), object.Size());
+    for (int i = 0; i < 1000; i++)
+        CPPUNIT_ASSERT_EQUAL(i, object.Get("key" + std::to_string(i)).AsNumber().To<int>());
+    CPPUNIT_ASSERT(!object.Has("key1000"));
+
+    int expected = 0;
+    for (const auto& [key, value]: object)
+        CPPUNIT_ASSERT_EQUAL(expected++, value.AsNumber().To<int>());
+
+    JsonObject moved = std::move(object);
+    CPPUNIT_ASSERT_EQUAL(999, moved["key999"].AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void CompositeTypesTest::TestLookupByView()
+{
+    std::string text = "key3=x;key15=y;key_missing";
+    std::string_view small_key = std::string_view(text).substr(0, 4);
+    std::string_view large_key = std::string_view(text).substr(7, 5);
+    std::string_view missing = std::string_view(text).substr(15);
+
+    for (int size: {4, 10000})
+    {
+        JsonObject object;
+        for (int i = 0; i < size; i++)
+            object.AddField("key" + std::to_string(i), i);
+        const JsonObject& const_object = object;
+
+        CPPUNIT_ASSERT(const_object.Has(small_key));
+        CPPUNIT_ASSERT_EQUAL(3, const_object[small_key].AsNumber().To<int>());
+        CPPUNIT_ASSERT_EQUAL(size > 15, const_object.Has(large_key));
+        CPPUNIT_ASSERT(!const_object.Has(missing));
+        CPPUNIT_ASSERT(!const_object.Has(""));
+        CPPUNIT_ASSERT_THROW(const_object.Get(missing), JsonException);
+    }
+}
+
+// =============================================================================
+
 } // namespace mj::test
 
 // =============================================================================
@@ -0,0 +1,146 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "document.hpp"
+#include "parser.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class DocumentTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(DocumentTest);
+
+    CPPUNIT_TEST(TestOutlivesInput);
+    CPPUNIT_TEST(TestEscapes);
+    CPPUNIT_TEST(TestMove);
+    CPPUNIT_TEST(TestRawNumbers);
+    CPPUNIT_TEST(TestErrors);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestOutlivesInput();
+    void TestEscapes();
+    void TestMove();
+    void TestRawNumbers();
+    void TestErrors();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DocumentTest);
+
+// =============================================================================
+
+namespace
+{
+
+template<typename Parse>
+std::string ErrorOf(Parse parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const JsonException& e)
+    {
+        return e.what();
+    }
+    return {};
+}
+
+} // namespace
+
+// =============================================================================
+
+void DocumentTest::TestOutlivesInput()
+{
+    auto input = std::make_unique<std::string>("{\"name\": \"value\", \"list\": [1, true, null, {\"a\": []}]}");
+    Document document{*input};
+    input.reset();
+
+    const ViewObject& object = document.AsObject();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("value"), object["name"].AsString());
+
+    const ViewArray& list = object["list"].AsArray();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), list.Size());
+    CPPUNIT_ASSERT_EQUAL(1, list[0].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(true, list[1].AsBool());
+    CPPUNIT_ASSERT(list[2].IsNull());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), list[3].AsObject()["a"].AsArray().Size());
+}
+
+// =============================================================================
+
+void DocumentTest::TestEscapes()
+{
+    Document document{R"({"key": ["a\"b\\c\/d", "😀!"]})"};
+
+    const ViewArray& array = document.AsObject()["key"].AsArray();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("a\"b\\c/d"), array[0].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("\xF0\x9F\x98\x80!"), array[1].AsString());
+}
+
+// =============================================================================
+
+void DocumentTest::TestMove()
+{
+    Document first{"[\"first\", [1, 2, 3]]"};
+    Document second{std::move(first)};
+    CPPUNIT_ASSERT_EQUAL(std::string_view("first"), second.AsArray()[0].AsString());
+
+    Document third{"{\"third\": [4]}"};
+    third = std::move(second);
+    CPPUNIT_ASSERT_EQUAL(std::string_view("first"), third.AsArray()[0].AsString());
+    CPPUNIT_ASSERT_EQUAL(3, third.AsArray()[1].AsArray()[2].AsNumber().To<int>());
+
+    Document scalar{" \"text\" "};
+    CPPUNIT_ASSERT_EQUAL(std::string_view("text"), scalar.AsString());
+    CPPUNIT_ASSERT(scalar.Root().IsString());
+}
+
+// =============================================================================
+
+void DocumentTest::TestRawNumbers()
+{
+    Document document{"[1.50, 123456789012345678901234567890]", JsonDeserializeOptions{.raw_numbers = true}};
+
+    const ViewArray& array = document.AsArray();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("1.50"), array[0].AsNumber().RawText());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("123456789012345678901234567890"), array[1].AsNumber().RawText());
+}
+
+// =============================================================================
+
+void DocumentTest::TestErrors()
+{
+    for (std::string bad: {"", "[1, 2", "{\"a\" 1}", R"("\x")", R"("\ud83d")"})
+        CPPUNIT_ASSERT_THROW(Document{bad}, JsonException);
+
+    CPPUNIT_ASSERT_THROW(Document("[[[1]]]", JsonDeserializeOptions{.max_depth = 2}), JsonException);
+
+    // The error is described in the input, not in the partly decoded copy
+    for (std::string bad: {R"({"text": "a\nb",
+"bad": "c\xd"})", R"({"a\q": 1})", R"(["ok", "\ud83d!"])"})
+    {
+        std::string expected = ErrorOf([&] { ParseFrom(bad); });
+        CPPUNIT_ASSERT(expected.find("invalid escape sequence at line") != std::string::npos);
+        CPPUNIT_ASSERT_EQUAL(expected, ErrorOf([&] { Document{bad}; }));
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
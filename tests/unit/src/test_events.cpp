@@ -0,0 +1,146 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "events.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class EventsTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(EventsTest);
+
+    CPPUNIT_TEST(TestScalars);
+    CPPUNIT_TEST(TestContainers);
+    CPPUNIT_TEST(TestStop);
+    CPPUNIT_TEST(TestErrors);
+    CPPUNIT_TEST(TestDeepNesting);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestScalars();
+    void TestContainers();
+    void TestStop();
+    void TestErrors();
+    void TestDeepNesting();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(EventsTest);
+
+// =============================================================================
+
+namespace
+{
+
+// Writes every event as a short token
+struct Recorder
+{
+    bool StartObject() { return Record("{"); }
+    bool Key(std::string_view key) { return Record("k:", key); }
+    bool EndObject(size_t count) { return Record("}", std::to_string(count)); }
+    bool StartArray() { return Record("["); }
+    bool EndArray(size_t count) { return Record("]", std::to_string(count)); }
+    bool String(std::string_view str) { return Record("s:", str); }
+    bool Number(JsonNumber number) { return Record("n:", std::to_string(number.To<int>())); }
+    bool Bool(bool b) { return Record(b ? "true" : "false"); }
+    bool Null() { return Record("null"); }
+
+    bool Record(std::string_view event, std::string_view value = {})
+    {
+        if (!events.empty())
+            events += ' ';
+        events += event;
+        events += value;
+        return --budget != 0;
+    }
+
+    std::string events;
+    int budget = -1;
+};
+
+static_assert(JsonEventHandler<Recorder>);
+
+std::string Events(std::string_view str, const JsonDeserializeOptions& options = {})
+{
+    Recorder recorder;
+    CPPUNIT_ASSERT(ParseEvents(str, recorder, options));
+    return recorder.events;
+}
+
+} // namespace
+
+// =============================================================================
+
+void EventsTest::TestScalars()
+{
+    CPPUNIT_ASSERT_EQUAL(std::string("true"), Events(" true "));
+    CPPUNIT_ASSERT_EQUAL(std::string("null"), Events("null"));
+    CPPUNIT_ASSERT_EQUAL(std::string("n:-12"), Events("-12"));
+    CPPUNIT_ASSERT_EQUAL(std::string("s:hello"), Events("\"hello\""));
+    CPPUNIT_ASSERT_EQUAL(std::string("s:a\"b\xC3\xA9"), Events(R"("a\"b\u00e9")"));
+    CPPUNIT_ASSERT_EQUAL(std::string("{ k:a\nb s:\\ }1"), Events(R"({"a\nb": "\\"})"));
+}
+
+// =============================================================================
+
+void EventsTest::TestContainers()
+{
+    CPPUNIT_ASSERT_EQUAL(std::string("[ ]0"), Events("[]"));
+    CPPUNIT_ASSERT_EQUAL(std::string("{ }0"), Events("{ }"));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("{ k:a n:1 k:b [ true null s:x { k:c false }1 ]4 }2"),
+        Events("{\"a\": 1, \"b\": [true, null, \"x\", {\"c\": false}]}"));
+}
+
+// =============================================================================
+
+void EventsTest::TestStop()
+{
+    Recorder recorder;
+    recorder.budget = 3;
+    CPPUNIT_ASSERT(!ParseEvents("[1, 2, 3, 4]", recorder));
+    CPPUNIT_ASSERT_EQUAL(std::string("[ n:1 n:2"), recorder.events);
+}
+
+// =============================================================================
+
+void EventsTest::TestErrors()
+{
+    Recorder recorder;
+    CPPUNIT_ASSERT_THROW(ParseEvents("[1, 2,]", recorder), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseEvents("{\"a\" 1}", recorder), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseEvents("[1] 2", recorder), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseEvents("", recorder), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseEvents("[NaN]", recorder, JsonDeserializeOptions{.strict = true}), JsonException);
+}
+
+// =============================================================================
+
+void EventsTest::TestDeepNesting()
+{
+    // NOTE: would overflow the stack of a recursive parser
+    static constexpr size_t DEPTH = 1'000'000;
+    std::string str = std::string(DEPTH, '[') + "1" + std::string(DEPTH, ']');
+
+    Recorder recorder;
+    CPPUNIT_ASSERT_THROW(ParseEvents(str, recorder), JsonException);
+
+    Recorder deep_recorder;
+    CPPUNIT_ASSERT(ParseEvents(str, deep_recorder, JsonDeserializeOptions{.max_depth = DEPTH}));
+    CPPUNIT_ASSERT_EQUAL(DEPTH * 5 + 3, deep_recorder.events.size());
+    CPPUNIT_ASSERT(deep_recorder.events.find("[ n:1 ]1 ]1") != std::string::npos);
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
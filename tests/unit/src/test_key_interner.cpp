@@ -0,0 +1,130 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+#include <vector>
+
+#include "compact.hpp"
+#include "document.hpp"
+#include "key_interner.hpp"
+#include "thread_pool.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class KeyInternerTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(KeyInternerTest);
+
+    CPPUNIT_TEST(TestIntern);
+    CPPUNIT_TEST(TestThreads);
+    CPPUNIT_TEST(TestDocuments);
+    CPPUNIT_TEST(TestCompact);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestIntern();
+    void TestThreads();
+    void TestDocuments();
+    void TestCompact();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(KeyInternerTest);
+
+// =============================================================================
+
+void KeyInternerTest::TestIntern()
+{
+    KeyInterner interner;
+    std::string text = "timestamp";
+    InternedKey first = interner.Intern(text);
+    text = "level";
+    InternedKey second = interner.Intern(text);
+
+    CPPUNIT_ASSERT(first == interner.Intern("timestamp"));
+    CPPUNIT_ASSERT(!(first == second));
+    CPPUNIT_ASSERT_EQUAL(std::string_view("timestamp"), first.View());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("level"), second.View());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), interner.Size());
+
+    CPPUNIT_ASSERT_EQUAL(std::string_view(""), interner.Intern("").View());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), interner.Size());
+}
+
+// =============================================================================
+
+void KeyInternerTest::TestThreads()
+{
+    KeyInterner interner;
+    ThreadPool pool{4};
+
+    constexpr size_t KEYS = 40;
+    std::vector<const char*> seen(KEYS * 100);
+    pool.Run(seen.size(), [&](size_t i) {
+        seen[i] = interner.Intern("key_" + std::to_string(i % KEYS)).Data();
+    });
+
+    CPPUNIT_ASSERT_EQUAL(KEYS, interner.Size());
+    for (size_t i = 0; i < seen.size(); i++)
+        CPPUNIT_ASSERT(seen[i] == seen[i % KEYS]);
+}
+
+// =============================================================================
+
+void KeyInternerTest::TestDocuments()
+{
+    KeyInterner interner;
+    JsonDeserializeOptions options{.key_interner = &interner};
+
+    Document first{R"({"host": "a", "level": 1})", options};
+    Document second{R"({"level": 2, "host": "b"})", options};
+    Document plain{R"({"level": 3})"};
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), interner.Size());
+    CPPUNIT_ASSERT(first.AsObject().begin()->first.data() == (second.AsObject().begin() + 1)->first.data());
+
+    InternedKey level = interner.Intern("level");
+    CPPUNIT_ASSERT_EQUAL(1, first.AsObject()[level].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(2, second.AsObject()[level].AsNumber().To<int>());
+    CPPUNIT_ASSERT(!first.AsObject().Has(interner.Intern("missing")));
+
+    // Lookups by string still work, lookups by handle only see interned keys
+    CPPUNIT_ASSERT_EQUAL(std::string_view("b"), second.AsObject()["host"].AsString());
+    CPPUNIT_ASSERT(!plain.AsObject().Has(level));
+    CPPUNIT_ASSERT_THROW(plain.AsObject()[level], JsonException);
+}
+
+// =============================================================================
+
+void KeyInternerTest::TestCompact()
+{
+    KeyInterner interner;
+    JsonDeserializeOptions options{.key_interner = &interner};
+
+    CompactDocument document{R"([{"id": 1, "a much longer key name": true}, {"id": 2}])", options};
+    InternedKey id = interner.Intern("id");
+
+    const CompactNode& root = document.Root();
+    CPPUNIT_ASSERT_EQUAL(1, root[0][id].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(2, root[1][id].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(true, root[0][interner.Intern("a much longer key name")].AsBool());
+    CPPUNIT_ASSERT_EQUAL(2, root[1]["id"].AsNumber().To<int>());
+
+    CompactDocument plain{R"({"id": 3})"};
+    CPPUNIT_ASSERT(!plain.Root().Has(id));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), interner.Size());
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -0,0 +1,199 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "lazy.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class LazyTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(LazyTest);
+
+    CPPUNIT_TEST(TestScalars);
+    CPPUNIT_TEST(TestObject);
+    CPPUNIT_TEST(TestArray);
+    CPPUNIT_TEST(TestIteration);
+    CPPUNIT_TEST(TestSkippedValuesAreNotValidated);
+    CPPUNIT_TEST(TestErrors);
+    CPPUNIT_TEST(TestMaterialize);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestScalars();
+    void TestObject();
+    void TestArray();
+    void TestIteration();
+    void TestSkippedValuesAreNotValidated();
+    void TestErrors();
+    void TestMaterialize();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LazyTest);
+
+// =============================================================================
+
+void LazyTest::TestScalars()
+{
+    CPPUNIT_ASSERT_EQUAL(true, LazyDocument(" true ").AsBool());
+    CPPUNIT_ASSERT_EQUAL(false, LazyDocument("false").AsBool());
+    CPPUNIT_ASSERT_EQUAL(nullptr, LazyDocument("null").AsNull());
+    CPPUNIT_ASSERT_EQUAL(-123, LazyDocument("\n-123").AsNumber().To<int>());
+    CPPUNIT_ASSERT(AlmostEqual(2.5e-3, LazyDocument("2.5e-3").AsNumber()));
+    CPPUNIT_ASSERT_EQUAL(std::string("hello json"), LazyDocument("\"hello json\"").AsString());
+
+    CPPUNIT_ASSERT(LazyDocument("1").IsNumber());
+    CPPUNIT_ASSERT(LazyDocument("-0.5").IsNumber());
+    CPPUNIT_ASSERT(LazyDocument("NaN").IsNumber());
+    CPPUNIT_ASSERT(!LazyDocument("NaN", JsonDeserializeOptions{.strict = true}).IsNumber());
+    CPPUNIT_ASSERT(!LazyDocument("[xyz]").AsArray()[0].IsNumber());
+    CPPUNIT_ASSERT(!LazyDocument("nul").IsNumber());
+    CPPUNIT_ASSERT(LazyDocument("\"1\"").IsString());
+    CPPUNIT_ASSERT(LazyDocument("[1]").IsArray());
+    CPPUNIT_ASSERT(LazyDocument("{}").IsObject());
+    CPPUNIT_ASSERT(LazyDocument("null").IsNull());
+    CPPUNIT_ASSERT(LazyDocument("true").IsBool());
+}
+
+// =============================================================================
+
+void LazyTest::TestObject()
+{
+    LazyDocument doc{"{\"k1\" : true, \"k2\": {\"k4\": false, \"k5\": 6}, \"k3\": [1, null, \"x\"], \"k6\": \"v\"}"};
+    LazyObject object = doc.AsObject();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), object.Size());
+    CPPUNIT_ASSERT(object.Has("k3"));
+    CPPUNIT_ASSERT(!object.Has("k4"));
+    CPPUNIT_ASSERT_EQUAL(true, object.Get("k1").AsBool());
+    CPPUNIT_ASSERT_EQUAL(6, object["k2"].AsObject()["k5"].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(std::string("x"), object["k3"].AsArray()[2].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("v"), object["k6"].AsString());
+    CPPUNIT_ASSERT_THROW(object.Get("k7"), JsonException);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), LazyDocument("{ }").AsObject().Size());
+}
+
+// =============================================================================
+
+void LazyTest::TestArray()
+{
+    LazyDocument doc{"[ 1 , null\n ,[\"hello\", false] ,\"hello\" \r , {\"k1\": true}, false  \r,3.4 ] "};
+    LazyArray array = doc.AsArray();
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(7), array.Size());
+    CPPUNIT_ASSERT_EQUAL(1, array[0].AsNumber().To<int>());
+    CPPUNIT_ASSERT(array[1].IsNull());
+    CPPUNIT_ASSERT_EQUAL(false, array[2].AsArray()[1].AsBool());
+    CPPUNIT_ASSERT_EQUAL(std::string("hello"), array[3].AsString());
+    CPPUNIT_ASSERT_EQUAL(true, array[4].AsObject()["k1"].AsBool());
+    CPPUNIT_ASSERT(AlmostEqual(3.4, array.At(6).AsNumber()));
+    CPPUNIT_ASSERT_THROW(array.At(7), JsonException);
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), LazyDocument("[]").AsArray().Size());
+}
+
+// =============================================================================
+
+void LazyTest::TestIteration()
+{
+    LazyDocument doc{"{\"a\": 1, \"b\": [2, 3], \"c\": \"}\"}"};
+
+    std::string keys;
+    for (const auto& [key, value]: doc.AsObject())
+        keys += std::string(key) + "=" + std::string(value.Raw()) + ";";
+    CPPUNIT_ASSERT_EQUAL(std::string("a=1;b=[2, 3];c=\"}\";"), keys);
+
+    int sum = 0;
+    for (const LazyValue& value: doc.AsObject()["b"].AsArray())
+        sum += value.AsNumber().To<int>();
+    CPPUNIT_ASSERT_EQUAL(5, sum);
+
+    // Keys are decoded like those of JsonObject and can be looked up again
+    LazyDocument escaped{"{\"caf\\u00e9\": 1, \"a\\\"b\": 2}"};
+    LazyObject object = escaped.AsObject();
+    std::vector<LazyObject::Iterator> fields;
+    for (auto it = object.begin(); it != object.end(); ++it)
+        fields.push_back(it);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), fields.size());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("caf\xc3\xa9"), fields[0]->first);
+    CPPUNIT_ASSERT_EQUAL(std::string_view("a\"b"), fields[1]->first);
+    for (const auto& it: fields)
+        CPPUNIT_ASSERT_EQUAL(it->second.Raw(), object[it->first].Raw());
+
+    // end() does not walk the container, stopping early never sees the broken tail
+    LazyDocument broken{"{\"list\": [1, 2 3"};
+    for (const auto& [key, value]: broken.AsObject())
+    {
+        for (const LazyValue& item: value.AsArray())
+        {
+            CPPUNIT_ASSERT_EQUAL(1, item.AsNumber().To<int>());
+            break;
+        }
+        CPPUNIT_ASSERT_EQUAL(std::string_view("list"), key);
+        break;
+    }
+    CPPUNIT_ASSERT(broken.AsObject().begin() != broken.AsObject().end());
+    CPPUNIT_ASSERT(doc.AsObject()["b"].AsArray().begin() != doc.AsObject()["b"].AsArray().end());
+    LazyDocument empty{"[ ]"};
+    CPPUNIT_ASSERT(empty.AsArray().begin() == empty.AsArray().end());
+}
+
+// =============================================================================
+
+void LazyTest::TestSkippedValuesAreNotValidated()
+{
+    LazyDocument doc{"{\"skipped\": [1, 2 3, {\"x\" tru}], \"wanted\": 42}"};
+    CPPUNIT_ASSERT_EQUAL(42, doc.AsObject()["wanted"].AsNumber().To<int>());
+    CPPUNIT_ASSERT_THROW(doc.AsObject()["skipped"].Materialize(), JsonException);
+}
+
+// =============================================================================
+
+void LazyTest::TestErrors()
+{
+    CPPUNIT_ASSERT_THROW(LazyDocument("  "), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("trues").AsBool(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("nulls").AsNull(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("12x").AsNumber(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("\"abc").AsString(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("[1, 2").AsArray().Size(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("[1, 2,]").AsArray().Size(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("{\"a\" 1}").AsObject().Get("a"), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("{\"a\": 1 \"b\": 2}").AsObject().Get("b"), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("[1]").AsObject(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("{}").AsArray(), JsonException);
+    CPPUNIT_ASSERT_THROW(LazyDocument("1").AsString(), JsonException);
+
+    JsonDeserializeOptions strict{.strict = true};
+    CPPUNIT_ASSERT_THROW(LazyDocument("[NaN]", strict).AsArray()[0].AsNumber(), JsonException);
+}
+
+// =============================================================================
+
+void LazyTest::TestMaterialize()
+{
+    LazyDocument doc{"{\"meta\": {\"id\": 7}, \"items\": [1, {\"k\": [true]}]}"};
+
+    JsonNode items = doc.AsObject()["items"].Materialize();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), items.AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(true, items.AsArray()[1].AsObject()["k"].AsArray()[0].AsBool());
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
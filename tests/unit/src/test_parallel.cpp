@@ -0,0 +1,240 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+#include "parallel.hpp"
+#include "parser.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class ParallelTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ParallelTest);
+
+    CPPUNIT_TEST(TestThreadPool);
+    CPPUNIT_TEST(TestNdjsonOrder);
+    CPPUNIT_TEST(TestNdjsonBlankLines);
+    CPPUNIT_TEST(TestNdjsonErrors);
+    CPPUNIT_TEST(TestArrayParallel);
+    CPPUNIT_TEST(TestArrayMisalignedSplits);
+    CPPUNIT_TEST(TestArrayErrors);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestThreadPool();
+    void TestNdjsonOrder();
+    void TestNdjsonBlankLines();
+    void TestNdjsonErrors();
+    void TestArrayParallel();
+    void TestArrayMisalignedSplits();
+    void TestArrayErrors();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelTest);
+
+// =============================================================================
+
+namespace
+{
+
+std::string MakeNdjson(size_t count)
+{
+    std::string str;
+    for (size_t i = 0; i < count; i++)
+        str += "{\"id\": " + std::to_string(i) + ", \"tags\": [\"a\", \"b\"], \"name\": \"record\"}\n";
+    return str;
+}
+
+// The message of the JsonException thrown by `parse`, empty if there is none
+template<typename Parse>
+std::string ErrorOf(Parse parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const JsonException& e)
+    {
+        return e.what();
+    }
+    return {};
+}
+
+// =============================================================================
+
+std::string Dump(const JsonNode& node)
+{
+    std::ostringstream stream;
+    node.SerializeToStream(stream);
+    return stream.str();
+}
+
+// =============================================================================
+
+// Big enough to be split, every element holds commas that look like
+// top-level ones: before nested objects with the same first key and inside
+// strings
+std::string MakeTrickyArray(size_t count)
+{
+    std::string str = "[";
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0)
+            str += ",";
+        str += "{\"id\": " + std::to_string(i) +
+               ", \"nested\": [{\"id\": 1},{\"id\": [{\"c\": 2}, {\"d\": 3}]}]" +
+               ", \"text\": \"x\\\",{\\\\\\\",{\"}";
+    }
+    return str + "]";
+}
+
+} // namespace
+
+// =============================================================================
+
+void ParallelTest::TestThreadPool()
+{
+    ThreadPool pool{4};
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(4), pool.Size());
+
+    std::vector<int> done(1000, 0);
+    for (int round = 1; round <= 3; round++)
+    {
+        pool.Run(done.size(), [&](size_t index) { done[index]++; });
+        CPPUNIT_ASSERT(std::all_of(done.begin(), done.end(), [&](int n) { return n == round; }));
+    }
+
+    CPPUNIT_ASSERT_THROW(pool.Run(10, [](size_t index) { if (index == 7) throw JsonException("task"); }),
+                         JsonException);
+}
+
+// =============================================================================
+
+void ParallelTest::TestNdjsonOrder()
+{
+    static constexpr size_t COUNT = 20000;
+    std::string str = MakeNdjson(COUNT);
+
+    for (size_t threads: {1, 3, 8})
+    {
+        ThreadPool pool{threads};
+        std::vector<JsonNode> nodes = ParseNdjson(str, pool);
+        CPPUNIT_ASSERT_EQUAL(COUNT, nodes.size());
+        for (size_t i = 0; i < COUNT; i++)
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(i), nodes[i].AsObject()["id"].AsNumber().To<int>());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT, ParseNdjson(str).size());
+}
+
+// =============================================================================
+
+void ParallelTest::TestNdjsonBlankLines()
+{
+    std::vector<JsonNode> nodes = ParseNdjson("\n1\r\n  \n[2]\n\"3\"");
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), nodes.size());
+    CPPUNIT_ASSERT_EQUAL(1, nodes[0].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), nodes[1].AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(std::string("3"), nodes[2].AsString());
+
+    CPPUNIT_ASSERT(ParseNdjson("").empty());
+}
+
+// =============================================================================
+
+void ParallelTest::TestNdjsonErrors()
+{
+    std::string str = MakeNdjson(10000) + "{\"id\": }\n" + MakeNdjson(10000);
+
+    ThreadPool pool{4};
+    try
+    {
+        ParseNdjson(str, pool);
+        CPPUNIT_FAIL("malformed line was accepted");
+    }
+    catch (const JsonException& e)
+    {
+        CPPUNIT_ASSERT(std::string(e.what()).ends_with("(line 10001)"));
+    }
+
+    CPPUNIT_ASSERT_THROW(ParseNdjson("[1, NaN]", JsonDeserializeOptions{.strict = true}), JsonException);
+}
+
+// =============================================================================
+
+void ParallelTest::TestArrayParallel()
+{
+    std::string str = "  [" + MakeNdjson(30000) + "1]  ";
+    std::replace(str.begin(), str.end(), '\n', ',');
+
+    ThreadPool pool{4};
+    JsonNode node = ParseArrayParallel(str, pool);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(30001), node.AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(Dump(ParseFrom(str)), Dump(node));
+
+    // Small and non-array documents go through ParseFrom
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), ParseArrayParallel("[1, 2]", pool).AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(std::string("x"), ParseArrayParallel("{\"a\": \"x\"}", pool).AsObject()["a"].AsString());
+}
+
+// =============================================================================
+
+void ParallelTest::TestArrayMisalignedSplits()
+{
+    std::string str = MakeTrickyArray(20000);
+    std::string expected = Dump(ParseFrom(str));
+
+    for (size_t threads: {2, 5, 16})
+    {
+        ThreadPool pool{threads};
+        CPPUNIT_ASSERT_EQUAL(expected, Dump(ParseArrayParallel(str, pool)));
+    }
+}
+
+// =============================================================================
+
+void ParallelTest::TestArrayErrors()
+{
+    ThreadPool pool{4};
+    std::string str = MakeTrickyArray(20000);
+
+    // Failures are reported exactly like ParseFrom does
+    auto check = [&](const std::string& bad, const JsonDeserializeOptions& options = {}) {
+        std::string expected = ErrorOf([&] { ParseFrom(bad, options); });
+        CPPUNIT_ASSERT(!expected.empty());
+        CPPUNIT_ASSERT_EQUAL(expected, ErrorOf([&] { ParseArrayParallel(bad, pool, options); }));
+    };
+
+    std::string bad = str;
+    bad.insert(bad.find("{\"id\": 10000,"), 1, '}');
+    check(bad);
+
+    bad = str;
+    bad.insert(bad.size() - 1, 1, ',');
+    check(bad);
+
+    bad = str;
+    bad[bad.find("{\"id\": 15000,") - 1] = ' ';
+    check(bad);
+
+    check(str, JsonDeserializeOptions{.max_depth = 5});
+    CPPUNIT_ASSERT_NO_THROW(ParseArrayParallel(str, pool, JsonDeserializeOptions{.max_depth = 6}));
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
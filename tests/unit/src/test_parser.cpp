@@ -1,6 +1,17 @@
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <bit>
+#include <charconv>
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <sys/stat.h>
 
 #include "parser.hpp"
 
@@ -20,13 +31,24 @@ class ParserTest : public CppUnit::TestFixture
     CPPUNIT_TEST(TestBool);
     CPPUNIT_TEST(TestNull);
     CPPUNIT_TEST(TestNumber);
+    CPPUNIT_TEST(TestNumberGrammar);
+    CPPUNIT_TEST(TestNumberRounding);
+    CPPUNIT_TEST(TestNumberTypes);
+    CPPUNIT_TEST(TestRawNumbers);
     CPPUNIT_TEST(TestString);
+    CPPUNIT_TEST(TestStringEscapes);
     CPPUNIT_TEST(TestEmptyArray);
     CPPUNIT_TEST(TestPlainArray);
     CPPUNIT_TEST(TestComplexArray);
     CPPUNIT_TEST(TestEmptyObject);
     CPPUNIT_TEST(TestPlainObject);
     CPPUNIT_TEST(TestComplexObject);
+    CPPUNIT_TEST(TestTokenTail);
+    CPPUNIT_TEST(TestLargeNumberArray);
+    CPPUNIT_TEST(TestMaxDepth);
+    CPPUNIT_TEST(TestParseFile);
+    CPPUNIT_TEST(TestTryParse);
+    CPPUNIT_TEST(TestErrorPositions);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -34,13 +56,24 @@ protected:
     void TestBool();
     void TestNull();
     void TestNumber();
+    void TestNumberGrammar();
+    void TestNumberRounding();
+    void TestNumberTypes();
+    void TestRawNumbers();
     void TestString();
+    void TestStringEscapes();
     void TestEmptyArray();
     void TestPlainArray();
     void TestComplexArray();
     void TestEmptyObject();
     void TestPlainObject();
     void TestComplexObject();
+    void TestTokenTail();
+    void TestLargeNumberArray();
+    void TestMaxDepth();
+    void TestParseFile();
+    void TestTryParse();
+    void TestErrorPositions();
 };
 
 // =============================================================================
@@ -90,6 +123,133 @@ void ParserTest::TestNumber()
 
 // =============================================================================
 
+void ParserTest::TestNumberGrammar()
+{
+    CPPUNIT_ASSERT_EQUAL(0.0, ParseFrom("0").AsNumber().To<double>());
+    CPPUNIT_ASSERT_EQUAL(true, std::signbit(ParseFrom("-0").AsNumber().To<double>()));
+    CPPUNIT_ASSERT_EQUAL(100.0, ParseFrom("1E+2").AsNumber().To<double>());
+    CPPUNIT_ASSERT_EQUAL(0.0005, ParseFrom("0.5e-3").AsNumber().To<double>());
+    CPPUNIT_ASSERT_EQUAL(-1e-300, ParseFrom("-1e-300").AsNumber().To<double>());
+
+    for (const char* str: {"01", "-01", "1.", ".5", "+1", "1e", "1e+", "-", "--1", "0x10", "1.e3", "inf", "nan", "-NaN"})
+        CPPUNIT_ASSERT_THROW_MESSAGE(str, ParseFrom(str), JsonException);
+
+    // Out of the double range
+    CPPUNIT_ASSERT_EQUAL(true, std::isinf(ParseFrom("1e400").AsNumber().To<double>()));
+    CPPUNIT_ASSERT_EQUAL(-0.0, ParseFrom("-1e-400").AsNumber().To<double>());
+    CPPUNIT_ASSERT_EQUAL(true, std::isinf(ParseFrom("-123456789012345678901234567890e300").AsNumber().To<double>()));
+    CPPUNIT_ASSERT_EQUAL(0.0, ParseFrom("0.000000000000000000001234567890123456789012e-320").AsNumber().To<double>());
+    CPPUNIT_ASSERT_THROW(ParseFrom("1e400", JsonDeserializeOptions{.strict = true}), JsonException);
+}
+
+// =============================================================================
+
+void ParserTest::TestNumberRounding()
+{
+    auto check = [](const std::string& str) {
+        double expected;
+        std::from_chars(str.data(), str.data() + str.size(), expected);
+        double actual = ParseFrom(str).AsNumber().To<double>();
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(str, std::bit_cast<uint64_t>(expected), std::bit_cast<uint64_t>(actual));
+    };
+
+    // Halfway cases, subnormals, the limits, more than 19 digits
+    for (const char* str: {"9007199254740993", "9007199254740993.0", "2.2250738585072011e-308",
+                           "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062328e-324",
+                           "1.7976931348623157e308", "1.7976931348623158e308", "0.1", "0.3", "3.0e-1",
+                           "7.3177701707893310e+15", "1448997445238699", "8.589973e9", "123456789012345678901",
+                           "0.00000000000000000000012345678901234567890123", "9999999999999999999",
+                           "1.00000000000000011102230246251565404236316680908203125",
+                           "1.00000000000000011102230246251565404236316680908203124",
+                           "-65.613616999999977", "43.420273000000009"})
+    {
+        check(str);
+    }
+
+    std::mt19937_64 rng(42);
+    char buffer[64];
+    for (int i = 0; i < 100000; i++)
+    {
+        // Shortest and 17-digit forms of random bit patterns
+        double value = std::bit_cast<double>(rng());
+        if (!std::isfinite(value))
+            continue;
+        check(std::string(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value).ptr));
+        check(std::string(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                                std::chars_format::scientific, 16).ptr));
+
+        // Random digits with a random exponent
+        std::string digits = std::to_string(rng() % 10000000000000000000ull);
+        check(digits.substr(0, 1) + "." + digits.substr(1) + "e" + std::to_string(static_cast<int>(rng() % 600) - 300));
+    }
+}
+
+// =============================================================================
+
+void ParserTest::TestNumberTypes()
+{
+    auto parse = [](const char* str) { return ParseFrom(str).AsNumber(); };
+
+    CPPUNIT_ASSERT(parse("0").IsInt64());
+    CPPUNIT_ASSERT(parse("-1").IsInt64());
+    CPPUNIT_ASSERT(parse("-0").IsDouble());
+    CPPUNIT_ASSERT(parse("1.0").IsDouble());
+    CPPUNIT_ASSERT(parse("1e2").IsDouble());
+
+    CPPUNIT_ASSERT_EQUAL(int64_t{1700000000123456789}, parse("1700000000123456789").To<int64_t>());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<int64_t>::max(), parse("9223372036854775807").To<int64_t>());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<int64_t>::min(), parse("-9223372036854775808").To<int64_t>());
+    CPPUNIT_ASSERT(parse("9223372036854775808").IsUInt64());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(), parse("18446744073709551615").To<uint64_t>());
+
+    // Out of the integer range
+    CPPUNIT_ASSERT(parse("-9223372036854775809").IsDouble());
+    CPPUNIT_ASSERT(parse("18446744073709551616").IsDouble());
+    CPPUNIT_ASSERT_EQUAL(1.8446744073709552e19, parse("18446744073709551616").To<double>());
+}
+
+// =============================================================================
+
+void ParserTest::TestRawNumbers()
+{
+    JsonDeserializeOptions options{.raw_numbers = true};
+
+    std::string str = "[1,-0,1.50,1E+2,12345678901234567890123,3.141592653589793238462643383279,NaN]";
+    JsonNode node = ParseFrom(str, options);
+    JsonArray& array = node.AsArray();
+
+    CPPUNIT_ASSERT(array[5].AsNumber().IsRaw());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("3.141592653589793238462643383279"), array[5].AsNumber().RawText());
+    CPPUNIT_ASSERT(!array[6].AsNumber().IsRaw());
+
+    // Converted on first use, the text stays
+    CPPUNIT_ASSERT(array[0].AsNumber().IsInt64());
+    CPPUNIT_ASSERT_EQUAL(1, array[0].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(1.5, array[2].AsNumber().To<double>());
+    CPPUNIT_ASSERT(array[4].AsNumber().IsDouble());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("1.50"), array[2].AsNumber().RawText());
+
+    std::stringstream ss;
+    node.SerializeToStream(ss);
+    CPPUNIT_ASSERT_EQUAL(str, ss.str());
+
+    JsonNumber copy = array[3].AsNumber();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("1E+2"), copy.RawText());
+    CPPUNIT_ASSERT_EQUAL(100, copy.To<int>());
+    copy = array[5].AsNumber();
+    CPPUNIT_ASSERT_EQUAL(array[5].AsNumber().RawText(), copy.RawText());
+
+    CPPUNIT_ASSERT_THROW(JsonNumber::FromRaw("1.2.3").To<double>(), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseFrom("[01]", options), JsonException);
+
+    options.strict = true;
+    CPPUNIT_ASSERT_THROW(ParseFrom("[1e400]", options), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseFrom("[NaN]", options), JsonException);
+    CPPUNIT_ASSERT_NO_THROW(ParseFrom("[1e300, 123456789012345678901234567890]", options));
+}
+
+// =============================================================================
+
 void ParserTest::TestString()
 {
     CPPUNIT_ASSERT_EQUAL(std::string("hello json"), ParseFrom("\"hello json\"").AsString());
@@ -100,6 +260,33 @@ void ParserTest::TestString()
 
 // =============================================================================
 
+void ParserTest::TestStringEscapes()
+{
+    CPPUNIT_ASSERT_EQUAL(std::string("a\nb\tc"), ParseFrom(R"("a\nb\tc")").AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("\"/\\\b\f\r"), ParseFrom(R"("\"\/\\\b\f\r")").AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("caf\xC3\xA9"), ParseFrom(R"("caf\u00e9")").AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("\xE2\x82\xAC"), ParseFrom(R"("\u20AC")").AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("\xF0\x9F\x98\x80"), ParseFrom(R"("\ud83d\ude00")").AsString());
+
+    JsonNode node = ParseFrom(R"({"k\u0065y": ["\\", "x\"y"]})");
+    CPPUNIT_ASSERT(node.AsObject().Has("key"));
+    CPPUNIT_ASSERT_EQUAL(std::string("\\"), node.AsObject().Get("key").AsArray()[0].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string("x\"y"), node.AsObject().Get("key").AsArray()[1].AsString());
+
+    // Plain runs longer than a vector on both sides of the escapes
+    std::string run(100, 'a');
+    CPPUNIT_ASSERT_EQUAL(run + "\n" + run + "\"" + run,
+                         ParseFrom("[\"" + run + "\\n" + run + "\\\"" + run + "\"]").AsArray()[0].AsString());
+
+    for (std::string_view bad: {R"("\x")", R"("\u12")", R"("\u12G4")", R"("\ud83d")", R"("\ude00")",
+                                R"("\ud83d\u0041")"})
+    {
+        CPPUNIT_ASSERT_THROW_MESSAGE(std::string(bad), ParseFrom(bad), JsonException);
+    }
+}
+
+// =============================================================================
+
 void ParserTest::TestEmptyArray()
 {
     JsonNode node = ParseFrom("[]");
@@ -224,6 +411,17 @@ void ParserTest::TestComplexObject()
     CPPUNIT_ASSERT_EQUAL(1, child_array[0].AsNumber().To<int>());
     CPPUNIT_ASSERT_EQUAL(nullptr, child_array[1].AsNull());
 
+    // Fields of nested objects stay with their own object, keys in order
+    JsonNode nested = ParseFrom(R"({"a rather long key 1": {"a rather long key 2": {}, "x": [{"y": 1}]}, "z": 2, "z": 3})");
+    std::string keys;
+    for (const auto& [key, value]: nested.AsObject())
+        keys += key + ";";
+    CPPUNIT_ASSERT_EQUAL(std::string("a rather long key 1;z;"), keys);
+    CPPUNIT_ASSERT_EQUAL(2, nested.AsObject()["z"].AsNumber().To<int>());
+    const JsonObject& outer = nested.AsObject()["a rather long key 1"].AsObject();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), outer.Size());
+    CPPUNIT_ASSERT_EQUAL(1, outer["x"].AsArray()[0].AsObject()["y"].AsNumber().To<int>());
+
     CPPUNIT_ASSERT_THROW(ParseFrom("{\"k1\" : true, \"k2\": {\"k4\":, false, \"k5\": 6}, \"k3\": [1,null]}"),
                          JsonException);
     CPPUNIT_ASSERT_THROW(ParseFrom("{\"k1\" : true, \"k2\": {\"k4\": false, \"k5\": 6},, \"k3\": [1,null]}"),
@@ -234,6 +432,151 @@ void ParserTest::TestComplexObject()
 
 // =============================================================================
 
+void ParserTest::TestTokenTail()
+{
+    auto [number, number_tail] = ParseNumber("12.5 , true ", JsonDeserializeOptions{});
+    CPPUNIT_ASSERT(AlmostEqual(12.5, number.AsNumber()));
+    CPPUNIT_ASSERT_EQUAL(std::string_view(", true"), number_tail);
+
+    auto [array, array_tail] = ParseArray("[1, [2]]  ]", JsonDeserializeOptions{});
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), array.AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("]"), array_tail);
+
+    std::string_view bad = "[1, 2";
+    auto [failed, failed_tail] = ParseArray(bad, JsonDeserializeOptions{});
+    CPPUNIT_ASSERT(failed.IsNull());
+    CPPUNIT_ASSERT_EQUAL(bad, failed_tail);
+}
+
+// =============================================================================
+
+void ParserTest::TestLargeNumberArray()
+{
+    static constexpr size_t COUNT = 200000;
+
+    std::string str = "[";
+    for (size_t i = 0; i < COUNT; i++)
+        str += std::to_string(i) + (i + 1 < COUNT ? ", " : "]");
+
+    JsonNode node = ParseFrom(str);
+    const JsonArray& array = node.AsArray();
+    CPPUNIT_ASSERT_EQUAL(COUNT, array.Size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(COUNT - 1), array[COUNT - 1].AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void ParserTest::TestMaxDepth()
+{
+    auto nested = [](size_t depth) { return std::string(depth, '[') + std::string(depth, ']'); };
+
+    JsonDeserializeOptions options;
+    CPPUNIT_ASSERT_NO_THROW(ParseFrom(nested(options.max_depth)));
+    CPPUNIT_ASSERT_THROW(ParseFrom(nested(options.max_depth + 1)), JsonException);
+    CPPUNIT_ASSERT_THROW(ParseFrom("{\"a\": " + nested(options.max_depth) + "}"), JsonException);
+
+    options.max_depth = 2;
+    CPPUNIT_ASSERT_NO_THROW(ParseFrom("[{\"a\": 1}, [], {}]", options));
+    CPPUNIT_ASSERT_THROW(ParseFrom("[{\"a\": [1]}]", options), JsonException);
+}
+
+// =============================================================================
+
+void ParserTest::TestParseFile()
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "myjson-test-parse-file.json";
+    auto write = [&](std::string_view content) { std::ofstream(path, std::ios::binary) << content; };
+
+    write(" {\"a\": [1, 2, {\"b\": \"c\"}], \"d\": null} \n");
+    JsonNode node = ParseFile(path);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), node.AsObject()["a"].AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(std::string("c"), node.AsObject()["a"].AsArray()[2].AsObject()["b"].AsString());
+
+    write("");
+    CPPUNIT_ASSERT_THROW(ParseFile(path), JsonException);
+
+    write("[1, 2");
+    CPPUNIT_ASSERT_THROW(ParseFile(path), JsonException);
+
+    std::filesystem::remove(path);
+    CPPUNIT_ASSERT_THROW(ParseFile(path), JsonException);
+
+    // A pipe has no size to map, it is read to its end instead
+    CPPUNIT_ASSERT_EQUAL(0, ::mkfifo(path.c_str(), 0600));
+    std::thread writer{[&] { write("[1, 2, 3]"); }};
+    node = ParseFile(path);
+    writer.join();
+    std::filesystem::remove(path);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), node.AsArray().Size());
+
+    CPPUNIT_ASSERT_THROW(ParseFile(std::filesystem::temp_directory_path()), JsonException);
+}
+
+// =============================================================================
+
+void ParserTest::TestTryParse()
+{
+    Expected<JsonNode, ParseError> result = TryParse(R"({"a": [1, "x", null]})");
+    CPPUNIT_ASSERT(result.has_value());
+    CPPUNIT_ASSERT_EQUAL(std::string("x"), result->AsObject().Get("a").AsArray()[1].AsString());
+
+    result = TryParse("[1, 2");
+    CPPUNIT_ASSERT(!result);
+    CPPUNIT_ASSERT(result.error().code == ParseErrorCode::UnexpectedEnd);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), result.error().offset);
+    CPPUNIT_ASSERT_THROW(result.value(), JsonException);
+
+    // Same documents, same verdict as ParseFrom
+    for (std::string_view str: {"", "[", "{\"a\" 1}", "[1,]", "nul", "\"\\q\"", "[1] 2", "-", "[\"abc]"})
+    {
+        CPPUNIT_ASSERT_THROW_MESSAGE(std::string(str), ParseFrom(str), JsonException);
+        CPPUNIT_ASSERT_MESSAGE(std::string(str), !TryParse(str).has_value());
+    }
+}
+
+// =============================================================================
+
+void ParserTest::TestErrorPositions()
+{
+    auto check = [](std::string_view str, ParseErrorCode code, size_t offset, size_t line, size_t column,
+                    const JsonDeserializeOptions& options = {}) {
+        Expected<JsonNode, ParseError> result = TryParse(str, options);
+        CPPUNIT_ASSERT_MESSAGE(std::string(str), !result.has_value());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string(str), ToString(code), ToString(result.error().code));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string(str), offset, result.error().offset);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string(str), line, result.error().line);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string(str), column, result.error().column);
+    };
+
+    JsonDeserializeOptions strict{.strict = true};
+    check("  ", ParseErrorCode::EmptyInput, 2, 1, 3);
+    check("x", ParseErrorCode::UnexpectedCharacter, 0, 1, 1);
+    check("[1 2]", ParseErrorCode::UnexpectedCharacter, 3, 1, 4);
+    check("{\"a\": 1,\n \"b\" 2}", ParseErrorCode::UnexpectedCharacter, 14, 2, 6);
+    check("{\n  \"a\": tru\n}", ParseErrorCode::InvalidLiteral, 9, 2, 8);
+    check("[1,\n-]", ParseErrorCode::InvalidNumber, 4, 2, 1);
+    check("[1e400]", ParseErrorCode::NumberOutOfRange, 1, 1, 2, strict);
+    check("[\"ok\", \"abc]", ParseErrorCode::UnterminatedString, 7, 1, 8);
+    check("[\"a\\x\"]", ParseErrorCode::InvalidEscape, 1, 1, 2);
+    check("[\"a\", \"\xFF\"]", ParseErrorCode::InvalidUtf8, 6, 1, 7, strict);
+    check("[[[1]]]", ParseErrorCode::TooDeep, 2, 1, 3, JsonDeserializeOptions{.max_depth = 2});
+    check("[]\n\n x", ParseErrorCode::TrailingCharacters, 5, 3, 2);
+    check("[1, [2, ", ParseErrorCode::UnexpectedEnd, 8, 1, 9);
+
+    try
+    {
+        ParseFrom("[1,\n 2 3]");
+        CPPUNIT_FAIL("no exception");
+    }
+    catch (const JsonException& e)
+    {
+        CPPUNIT_ASSERT_EQUAL(std::string("[JSON] Bad JSON: unexpected character at line 2, column 4: `3]...`"),
+                             std::string(e.what()));
+    }
+}
+
+// =============================================================================
+
 } // namespace mj::test
 
 // =============================================================================
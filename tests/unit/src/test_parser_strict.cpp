@@ -19,6 +19,7 @@ class ParserStrictTest : public CppUnit::TestFixture
     CPPUNIT_TEST(TestNull);
     CPPUNIT_TEST(TestNumber);
     CPPUNIT_TEST(TestString);
+    CPPUNIT_TEST(TestUtf8);
     CPPUNIT_TEST(TestEmptyArray);
     CPPUNIT_TEST(TestPlainArray);
     CPPUNIT_TEST(TestComplexArray);
@@ -36,6 +37,7 @@ protected:
     void TestNull();
     void TestNumber();
     void TestString();
+    void TestUtf8();
     void TestEmptyArray();
     void TestPlainArray();
     void TestComplexArray();
@@ -104,6 +106,25 @@ void ParserStrictTest::TestString()
 
 // =============================================================================
 
+void ParserStrictTest::TestUtf8()
+{
+    std::string text = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80";
+    CPPUNIT_ASSERT_EQUAL(text, ParseFrom("\"" + text + "\"", options).AsString());
+    CPPUNIT_ASSERT_EQUAL(text, ParseFrom("{\"" + text + "\": 1}", options).AsObject().begin()->first);
+
+    // Truncated, overlong, surrogate, above U+10FFFF, stray continuation
+    for (std::string bad: {"\xC3", "\xC0\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\x80", "\xFF"})
+    {
+        std::string doc = "[\"" + std::string(40, 'a') + bad + "\"]";
+        CPPUNIT_ASSERT_THROW(ParseFrom(doc, options), JsonException);
+        CPPUNIT_ASSERT_NO_THROW(ParseFrom(doc));
+        CPPUNIT_ASSERT(!ParseArray(doc, options).first.IsArray());
+        CPPUNIT_ASSERT(ParseArray(doc, {}).first.IsArray());
+    }
+}
+
+// =============================================================================
+
 void ParserStrictTest::TestEmptyArray()
 {
     JsonNode node = ParseFrom("[]", options);
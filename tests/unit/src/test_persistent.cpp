@@ -0,0 +1,175 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+#include <string>
+
+#include "parser.hpp"
+#include "persistent.hpp"
+#include "thread_pool.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class PersistentTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(PersistentTest);
+
+    CPPUNIT_TEST(TestFromJson);
+    CPPUNIT_TEST(TestSetShares);
+    CPPUNIT_TEST(TestErase);
+    CPPUNIT_TEST(TestArrays);
+    CPPUNIT_TEST(TestErrors);
+    CPPUNIT_TEST(TestConcurrentReads);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestFromJson();
+    void TestSetShares();
+    void TestErase();
+    void TestArrays();
+    void TestErrors();
+    void TestConcurrentReads();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PersistentTest);
+
+// =============================================================================
+
+namespace
+{
+
+std::string Serialize(const PersistentNode& node)
+{
+    std::stringstream ss;
+    node.Materialize().SerializeToStream(ss);
+    return ss.str();
+}
+
+} // namespace
+
+// =============================================================================
+
+void PersistentTest::TestFromJson()
+{
+    std::string text = R"({"name":"svc","port":8080,"debug":false,"ratio":0.5,"tags":["a",null],"limits":{}})";
+    PersistentNode node{ParseFrom(text)};
+
+    CPPUNIT_ASSERT_EQUAL(std::string("svc"), node["name"].AsString());
+    CPPUNIT_ASSERT_EQUAL(8080, node["port"].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(false, node["debug"].AsBool());
+    CPPUNIT_ASSERT(node["tags"][1].IsNull());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), node["limits"].Size());
+    CPPUNIT_ASSERT_EQUAL(text, Serialize(node));
+
+    PersistentNode copy = node;
+    CPPUNIT_ASSERT(copy.IsSameAs(node));
+    CPPUNIT_ASSERT(copy["tags"].IsSameAs(node["tags"]));
+}
+
+// =============================================================================
+
+void PersistentTest::TestSetShares()
+{
+    PersistentNode v1{ParseFrom(R"({"db":{"host":"a","port":1},"cache":{"size":10},"list":[1,2]})")};
+    PersistentNode v2 = v1.SetIn({"db", "port"}, 2);
+    PersistentNode v3 = v2.SetIn({"list", 0}, "first").Set("new", true);
+
+    // Old versions are untouched
+    CPPUNIT_ASSERT_EQUAL(1, v1["db"]["port"].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(2, v2["db"]["port"].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"db":{"host":"a","port":1},"cache":{"size":10},"list":[1,2]})"), Serialize(v1));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"db":{"host":"a","port":2},"cache":{"size":10},"list":[1,2]})"), Serialize(v2));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"db":{"host":"a","port":2},"cache":{"size":10},"list":["first",2],"new":true})"),
+                         Serialize(v3));
+
+    // Only the path to the change is new
+    CPPUNIT_ASSERT(!v2.IsSameAs(v1));
+    CPPUNIT_ASSERT(!v2["db"].IsSameAs(v1["db"]));
+    CPPUNIT_ASSERT(v2["db"]["host"].IsSameAs(v1["db"]["host"]));
+    CPPUNIT_ASSERT(v2["cache"].IsSameAs(v1["cache"]));
+    CPPUNIT_ASSERT(v3["db"].IsSameAs(v2["db"]));
+    CPPUNIT_ASSERT(!v3["list"].IsSameAs(v2["list"]));
+
+    // Keys are shared too, the copied object only refers to them
+    CPPUNIT_ASSERT_EQUAL(&v1.AsObject()[0].first.Str(), &v3.AsObject()[0].first.Str());
+    CPPUNIT_ASSERT(v3.AsObject()[3].first == "new");
+}
+
+// =============================================================================
+
+void PersistentTest::TestErase()
+{
+    PersistentNode v1{ParseFrom(R"({"a":{"b":1,"c":2},"d":3})")};
+    PersistentNode v2 = v1.EraseIn({"a", "b"});
+    PersistentNode v3 = v2.Erase("d");
+
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"a":{"b":1,"c":2},"d":3})"), Serialize(v1));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"a":{"c":2},"d":3})"), Serialize(v2));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"({"a":{"c":2}})"), Serialize(v3));
+
+    // Erasing what is not there changes nothing
+    CPPUNIT_ASSERT(v3.Erase("missing").IsSameAs(v3));
+}
+
+// =============================================================================
+
+void PersistentTest::TestArrays()
+{
+    PersistentNode empty = PersistentNode::MakeArray();
+    PersistentNode list = empty.PushBack(1).PushBack("two").PushBack(PersistentNode::MakeObject());
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), empty.Size());
+    CPPUNIT_ASSERT_EQUAL(std::string(R"([1,"two",{}])"), Serialize(list));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"([1,{}])"), Serialize(list.Erase(1)));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"([1,"two",{"k":null}])"), Serialize(list.SetIn({2, "k"}, nullptr)));
+    CPPUNIT_ASSERT_EQUAL(std::string(R"([1,"two",{}])"), Serialize(list));
+}
+
+// =============================================================================
+
+void PersistentTest::TestErrors()
+{
+    PersistentNode node{ParseFrom(R"({"list":[1],"text":"x"})")};
+
+    CPPUNIT_ASSERT_THROW(node["missing"], JsonException);
+    CPPUNIT_ASSERT_THROW(node["list"][1], JsonException);
+    CPPUNIT_ASSERT_THROW(node.SetIn({"list", 5}, 1), JsonException);
+    CPPUNIT_ASSERT_THROW(node.SetIn({"missing", "x"}, 1), JsonException);
+    CPPUNIT_ASSERT_THROW(node.SetIn({}, 1), JsonException);
+    CPPUNIT_ASSERT_THROW(node["text"].Set("k", 1), std::bad_variant_access);
+}
+
+// =============================================================================
+
+void PersistentTest::TestConcurrentReads()
+{
+    // Raw numbers are converted when the node is built, so the subtrees
+    // shared between snapshots are never written by their readers
+    PersistentNode v1{ParseFrom(R"({"list":[1.5,2,3]})", JsonDeserializeOptions{.raw_numbers = true})};
+    PersistentNode v2 = v1.Set("other", 1);
+
+    ThreadPool pool{4};
+    std::vector<double> sums(pool.Size());
+    pool.Run(sums.size(), [&](size_t task) {
+        const PersistentNode& list = (task % 2 ? v1 : v2)["list"];
+        for (int repeat = 0; repeat < 1000; repeat++)
+            sums[task] += list[0].AsNumber().To<double>() + list[1].AsNumber().To<double>();
+    });
+    for (double sum: sums)
+        CPPUNIT_ASSERT_EQUAL(3500.0, sum);
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -0,0 +1,149 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <sstream>
+
+#include "parser.hpp"
+#include "push_parser.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class PushParserTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(PushParserTest);
+
+    CPPUNIT_TEST(TestWholeDocument);
+    CPPUNIT_TEST(TestEverySplit);
+    CPPUNIT_TEST(TestSingleBytes);
+    CPPUNIT_TEST(TestErrors);
+    CPPUNIT_TEST(TestReuse);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestWholeDocument();
+    void TestEverySplit();
+    void TestSingleBytes();
+    void TestErrors();
+    void TestReuse();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PushParserTest);
+
+// =============================================================================
+
+namespace
+{
+
+const std::string DOCUMENT =
+    " {\"name\": \"a \\\"quoted\\\" \\\\ name\", \"values\": [1, -2.5e3, true, false, null, []],"
+    " \"nested\": {\"empty\": {}, \"list\": [{\"x\": 12345678}, \"\\u0041\"]}} ";
+
+std::string Dump(const JsonNode& node)
+{
+    std::ostringstream stream;
+    node.SerializeToStream(stream);
+    return stream.str();
+}
+
+JsonNode PushSplit(std::string_view str, size_t split)
+{
+    PushParser parser;
+    parser.Feed(str.substr(0, split));
+    parser.Feed(str.substr(split));
+    return parser.Finish();
+}
+
+} // namespace
+
+// =============================================================================
+
+void PushParserTest::TestWholeDocument()
+{
+    PushParser parser;
+    parser.Feed(DOCUMENT);
+    CPPUNIT_ASSERT_EQUAL(Dump(ParseFrom(DOCUMENT)), Dump(parser.Finish()));
+
+    parser.Feed("42");
+    CPPUNIT_ASSERT_EQUAL(42, parser.Finish().AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void PushParserTest::TestEverySplit()
+{
+    std::string expected = Dump(ParseFrom(DOCUMENT));
+    for (size_t split = 0; split <= DOCUMENT.size(); split++)
+        CPPUNIT_ASSERT_EQUAL(expected, Dump(PushSplit(DOCUMENT, split)));
+
+    for (std::string_view scalar: {"-12.75e-1", "true", "null", "\"ab\\\\\\\"cd\""})
+    {
+        std::string expected_scalar = Dump(ParseFrom(scalar));
+        for (size_t split = 0; split <= scalar.size(); split++)
+            CPPUNIT_ASSERT_EQUAL(expected_scalar, Dump(PushSplit(scalar, split)));
+    }
+}
+
+// =============================================================================
+
+void PushParserTest::TestSingleBytes()
+{
+    PushParser parser;
+    for (char c: DOCUMENT)
+        parser.Feed(std::string_view{&c, 1});
+    CPPUNIT_ASSERT_EQUAL(Dump(ParseFrom(DOCUMENT)), Dump(parser.Finish()));
+}
+
+// =============================================================================
+
+void PushParserTest::TestErrors()
+{
+    for (std::string_view bad: {"", "  ", "[1, 2", "[1, 2,]", "{\"a\" 1}", "{\"a\": 1,}", "[1] 2", "\"abc",
+                                "tru", "trues", "[1 2]", "{1: 2}", "]", "[}"})
+    {
+        CPPUNIT_ASSERT_THROW(ParseFrom(bad), JsonException);
+        CPPUNIT_ASSERT_THROW(
+            {
+                PushParser parser;
+                for (char c: bad)
+                    parser.Feed(std::string_view{&c, 1});
+                parser.Finish();
+            },
+            JsonException);
+    }
+
+    PushParser strict{JsonDeserializeOptions{.strict = true}};
+    strict.Feed("[Na");
+    CPPUNIT_ASSERT_THROW((strict.Feed("N]"), strict.Finish()), JsonException);
+
+    PushParser shallow{JsonDeserializeOptions{.max_depth = 1}};
+    CPPUNIT_ASSERT_THROW(shallow.Feed("[[1]]"), JsonException);
+}
+
+// =============================================================================
+
+void PushParserTest::TestReuse()
+{
+    PushParser parser;
+    parser.Feed("[1, ");
+    parser.Feed("2]");
+    CPPUNIT_ASSERT_EQUAL(size_t(2), parser.Finish().AsArray().Size());
+
+    parser.Feed("{\"a\"");
+    parser.Feed(": \"b\"}");
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), parser.Finish().AsObject()["a"].AsString());
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
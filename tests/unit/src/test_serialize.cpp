@@ -1,6 +1,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "json.hpp"
+#include "parser.hpp"
 
 #include "common.hpp"
 
@@ -20,10 +21,13 @@ class SerializeTest : public CppUnit::TestFixture
     CPPUNIT_TEST(TestNull);
     CPPUNIT_TEST(TestNumberInteger);
     CPPUNIT_TEST(TestNumberDouble);
+    CPPUNIT_TEST(TestNumberExact);
     CPPUNIT_TEST(TestNumberInfinite);
     CPPUNIT_TEST(TestString);
+    CPPUNIT_TEST(TestStringEscapes);
     CPPUNIT_TEST(TestArray);
     CPPUNIT_TEST(TestSortedObject);
+    CPPUNIT_TEST(TestObjectOrder);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -33,10 +37,13 @@ protected:
     void TestNull();
     void TestNumberInteger();
     void TestNumberDouble();
+    void TestNumberExact();
     void TestNumberInfinite();
     void TestString();
+    void TestStringEscapes();
     void TestArray();
     void TestSortedObject();
+    void TestObjectOrder();
 };
 
 // =============================================================================
@@ -95,6 +102,27 @@ void SerializeTest::TestNumberDouble()
 
 // =============================================================================
 
+void SerializeTest::TestNumberExact()
+{
+    auto dump = [](JsonNode node) {
+        std::stringstream ss;
+        node.SerializeToStream(ss, JsonSerializeOptions{});
+        return ss.str();
+    };
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1700000000123456789"), dump(JsonNode{int64_t{1700000000123456789}}));
+    CPPUNIT_ASSERT_EQUAL(std::string("-9223372036854775808"), dump(JsonNode{std::numeric_limits<int64_t>::min()}));
+    CPPUNIT_ASSERT_EQUAL(std::string("18446744073709551615"), dump(JsonNode{std::numeric_limits<uint64_t>::max()}));
+
+    // Shortest form that reads back to the same double
+    CPPUNIT_ASSERT_EQUAL(std::string("0.1"), dump(JsonNode{0.1}));
+    CPPUNIT_ASSERT_EQUAL(std::string("1e-13"), dump(JsonNode{1e-13}));
+    CPPUNIT_ASSERT_EQUAL(std::string("0.30000000000000004"), dump(JsonNode{0.1 + 0.2}));
+    CPPUNIT_ASSERT_EQUAL(std::string("-2"), dump(JsonNode{-2.0}));
+}
+
+// =============================================================================
+
 void SerializeTest::TestNumberInfinite()
 {
     std::stringstream ss1;
@@ -125,6 +153,20 @@ void SerializeTest::TestString()
 
 // =============================================================================
 
+void SerializeTest::TestStringEscapes()
+{
+    std::string text = "q\"b\\/\b\f\n\r\t\x01\x1F caf\xC3\xA9";
+    std::stringstream ss;
+    JsonNode node{JsonObject{std::make_pair(text, text)}};
+    node.SerializeToStream(ss, JsonSerializeOptions{});
+
+    std::string escaped = R"("q\"b\\/\b\f\n\r\t\u0001\u001f caf)" "\xC3\xA9\"";
+    CPPUNIT_ASSERT_EQUAL("{" + escaped + ":" + escaped + "}", ss.str());
+    CPPUNIT_ASSERT_EQUAL(text, ParseFrom(ss.str()).AsObject().Get(text).AsString());
+}
+
+// =============================================================================
+
 void SerializeTest::TestArray()
 {
     std::stringstream ss;
@@ -157,6 +199,16 @@ void SerializeTest::TestSortedObject()
 
 // =============================================================================
 
+void SerializeTest::TestObjectOrder()
+{
+    std::stringstream ss;
+    JsonNode node = ParseFrom(R"({"zeta": 1, "alpha": {"y": 2, "x": 3}, "mid": [], "alpha": 4})");
+    node.SerializeToStream(ss);
+    CPPUNIT_ASSERT_EQUAL(std::string("{\"zeta\":1,\"alpha\":{\"y\":2,\"x\":3},\"mid\":[]}"), ss.str());
+}
+
+// =============================================================================
+
 
 } // namespace mj::test
 
@@ -0,0 +1,175 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "detail/simd.hpp"
+#include "parser.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class SimdTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(SimdTest);
+
+    CPPUNIT_TEST(TestFindQuoteOrBackslash);
+    CPPUNIT_TEST(TestSkipWhitespaces);
+    CPPUNIT_TEST(TestLevelsAgree);
+    CPPUNIT_TEST(TestValidateUtf8);
+    CPPUNIT_TEST(TestLongTokens);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestFindQuoteOrBackslash();
+    void TestSkipWhitespaces();
+    void TestLevelsAgree();
+    void TestValidateUtf8();
+    void TestLongTokens();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SimdTest);
+
+// =============================================================================
+
+void SimdTest::TestFindQuoteOrBackslash()
+{
+    std::string s = std::string(40, 'a') + "\\" + std::string(20, 'b') + "\"";
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(40), detail::FindQuoteOrBackslash(s, 0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(61), detail::FindQuoteOrBackslash(s, 41));
+    CPPUNIT_ASSERT_EQUAL(s.size(), detail::FindQuoteOrBackslash(s, 62));
+    CPPUNIT_ASSERT_EQUAL(s.size(), detail::FindQuoteOrBackslash(s, s.size() + 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), detail::FindQuoteOrBackslash("", 0));
+}
+
+// =============================================================================
+
+void SimdTest::TestSkipWhitespaces()
+{
+    std::string s = std::string(37, ' ') + "\t\r\n" + "x" + std::string(50, '\n');
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(40), detail::SkipWhitespaces(s, 0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(40), detail::SkipWhitespaces(s, 40));
+    CPPUNIT_ASSERT_EQUAL(s.size(), detail::SkipWhitespaces(s, 41));
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), detail::SkipWhitespaces("\v", 0));
+}
+
+// =============================================================================
+
+void SimdTest::TestLevelsAgree()
+{
+    static const std::string alphabet = "  \t\n\r\"\\abcdefgh";
+
+    std::vector<detail::SimdLevel> levels{detail::SimdLevel::Scalar};
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Sse42)
+        levels.push_back(detail::SimdLevel::Sse42);
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Avx2)
+        levels.push_back(detail::SimdLevel::Avx2);
+
+    std::mt19937 rng(11);
+    for (size_t iteration = 0; iteration < 2000; iteration++)
+    {
+        std::string s(rng() % 200, ' ');
+        for (char& c: s)
+            c = alphabet[rng() % (iteration % 2 ? 5 : alphabet.size())];
+
+        size_t pos = s.empty() ? 0 : rng() % s.size();
+        size_t quote = detail::FindQuoteOrBackslash(s, pos, detail::SimdLevel::Scalar);
+        size_t space = detail::SkipWhitespaces(s, pos, detail::SimdLevel::Scalar);
+        size_t backslash = std::min(s.find('\\', pos), s.size());
+        for (detail::SimdLevel level: levels)
+        {
+            CPPUNIT_ASSERT_EQUAL(quote, detail::FindQuoteOrBackslash(s, pos, level));
+            CPPUNIT_ASSERT_EQUAL(space, detail::SkipWhitespaces(s, pos, level));
+
+            std::string copy(s.size() - pos, '\0');
+            CPPUNIT_ASSERT_EQUAL(backslash, detail::CopyUntilBackslash(s, pos, copy.data(), level));
+            CPPUNIT_ASSERT_EQUAL(s.substr(pos, backslash - pos), copy.substr(0, backslash - pos));
+        }
+    }
+}
+
+// =============================================================================
+
+void SimdTest::TestValidateUtf8()
+{
+    static const std::vector<std::string> valid = {
+        "", "plain ascii", "\x7F", "\xC2\x80", "\xDF\xBF", "\xE0\xA0\x80", "\xED\x9F\xBF", "\xEE\x80\x80",
+        "\xEF\xBF\xBF", "\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF",
+    };
+    static const std::vector<std::string> invalid = {
+        "\x80", "\xBF", "\xC0\x80", "\xC1\xBF", "\xC2", "\xC2\x41", "\xE0\x80\x80", "\xE0\x9F\xBF",
+        "\xED\xA0\x80", "\xED\xBF\xBF", "\xE1\x80", "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF",
+        "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xF1\x80\x80", "\xFE", "\xFF", "\xC2\x80\x80",
+    };
+
+    std::vector<detail::SimdLevel> levels{detail::SimdLevel::Scalar};
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Sse42)
+        levels.push_back(detail::SimdLevel::Sse42);
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Avx2)
+        levels.push_back(detail::SimdLevel::Avx2);
+
+    // Every sequence at every offset of a block, and across block ends
+    for (size_t offset = 0; offset < 70; offset++)
+    {
+        for (detail::SimdLevel level: levels)
+        {
+            for (const std::string& sequence: valid)
+            {
+                std::string s = std::string(offset, 'a') + sequence + "z";
+                CPPUNIT_ASSERT_MESSAGE(s, detail::ValidateUtf8(s, level));
+                CPPUNIT_ASSERT_MESSAGE(s, detail::ValidateUtf8(std::string_view(s).substr(0, s.size() - 1), level));
+            }
+            for (const std::string& sequence: invalid)
+            {
+                std::string s = std::string(offset, 'a') + sequence + "z";
+                CPPUNIT_ASSERT_MESSAGE(s, !detail::ValidateUtf8(s, level));
+                CPPUNIT_ASSERT_MESSAGE(s, !detail::ValidateUtf8(std::string_view(s).substr(0, s.size() - 1), level));
+            }
+        }
+    }
+
+    // Random mixes of valid sequences with the odd corrupted byte
+    std::mt19937 rng(5);
+    for (size_t iteration = 0; iteration < 3000; iteration++)
+    {
+        std::string s;
+        size_t size = rng() % 300;
+        while (s.size() < size)
+            s += valid[rng() % valid.size()];
+        if (iteration % 2 && !s.empty())
+            s[rng() % s.size()] = static_cast<char>(rng());
+
+        bool expected = detail::ValidateUtf8(s, detail::SimdLevel::Scalar);
+        for (detail::SimdLevel level: levels)
+            CPPUNIT_ASSERT_EQUAL(expected, detail::ValidateUtf8(s, level));
+    }
+}
+
+// =============================================================================
+
+void SimdTest::TestLongTokens()
+{
+    std::string text = std::string(100, 'x') + "\\\"" + std::string(100, 'y');
+    std::string str = std::string(70, ' ') + "\"" + text + "\"" + std::string(70, '\n');
+
+    auto [node, tail] = ParseString(std::string_view(str).substr(70), JsonDeserializeOptions{});
+    CPPUNIT_ASSERT_EQUAL(std::string(100, 'x') + "\"" + std::string(100, 'y'), node.AsString());
+    CPPUNIT_ASSERT(tail.empty());
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -1,5 +1,8 @@
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <cstdint>
+#include <limits>
+
 #include "json.hpp"
 #include "visitor.hpp"
 
@@ -21,6 +24,7 @@ class SimpleTypesTest : public CppUnit::TestFixture
     CPPUNIT_TEST(TestNull);
     CPPUNIT_TEST(TestNumberInteger);
     CPPUNIT_TEST(TestNumberDouble);
+    CPPUNIT_TEST(TestNumberTypes);
     CPPUNIT_TEST(TestString);
 
     CPPUNIT_TEST_SUITE_END();
@@ -31,6 +35,7 @@ protected:
     void TestNull();
     void TestNumberInteger();
     void TestNumberDouble();
+    void TestNumberTypes();
     void TestString();
 };
 
@@ -80,6 +85,27 @@ void SimpleTypesTest::TestNumberDouble()
 
 // =============================================================================
 
+void SimpleTypesTest::TestNumberTypes()
+{
+    CPPUNIT_ASSERT(JsonNumber{-5}.IsInt64());
+    CPPUNIT_ASSERT(JsonNumber{5u}.IsInt64());
+    CPPUNIT_ASSERT(JsonNumber{std::numeric_limits<uint64_t>::max()}.IsUInt64());
+    CPPUNIT_ASSERT(JsonNumber{5.0}.IsDouble());
+    CPPUNIT_ASSERT(JsonNumber{5.0f}.IsDouble());
+
+    // Above 2^53 a double can not hold these
+    int64_t timestamp = 1700000000123456789;
+    CPPUNIT_ASSERT_EQUAL(timestamp, JsonNode{timestamp}.AsNumber().To<int64_t>());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(),
+                         JsonNumber{std::numeric_limits<uint64_t>::max()}.To<uint64_t>());
+    CPPUNIT_ASSERT_EQUAL(int64_t{5}, JsonNumber{5u}.To<int64_t>());
+    CPPUNIT_ASSERT_EQUAL(255, JsonNumber{uint8_t{255}}.To<int>());
+    CPPUNIT_ASSERT_EQUAL(2.5, static_cast<double>(JsonNumber{2.5}));
+    CPPUNIT_ASSERT_EQUAL(2, JsonNumber{2.5}.To<int>());
+}
+
+// =============================================================================
+
 void SimpleTypesTest::TestString()
 {
     JsonNode node{"hello, json"};
@@ -0,0 +1,144 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <random>
+
+#include "detail/structural_index.hpp"
+#include "parser.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class StructuralIndexTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(StructuralIndexTest);
+
+    CPPUNIT_TEST(TestPositions);
+    CPPUNIT_TEST(TestEscapes);
+    CPPUNIT_TEST(TestUnterminatedString);
+    CPPUNIT_TEST(TestSimdLevelsAgree);
+    CPPUNIT_TEST(TestBlockBoundaries);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestPositions();
+    void TestEscapes();
+    void TestUnterminatedString();
+    void TestSimdLevelsAgree();
+    void TestBlockBoundaries();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StructuralIndexTest);
+
+// =============================================================================
+
+namespace
+{
+
+std::vector<uint32_t> Index(std::string_view str, detail::SimdLevel level = detail::DetectSimdLevel())
+{
+    std::vector<uint32_t> positions;
+    CPPUNIT_ASSERT(detail::BuildStructuralIndex(str, positions, level));
+    return positions;
+}
+
+std::vector<detail::SimdLevel> SupportedLevels()
+{
+    std::vector<detail::SimdLevel> levels{detail::SimdLevel::Scalar};
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Sse42)
+        levels.push_back(detail::SimdLevel::Sse42);
+    if (detail::DetectSimdLevel() >= detail::SimdLevel::Avx2)
+        levels.push_back(detail::SimdLevel::Avx2);
+    return levels;
+}
+
+} // namespace
+
+// =============================================================================
+
+void StructuralIndexTest::TestPositions()
+{
+    //                   0123456789012345678901234567
+    std::string_view s = "{\"a\": [1, true], \"b,\":null}";
+    std::vector<uint32_t> expected{0, 1, 3, 4, 6, 7, 8, 10, 14, 15, 17, 20, 21, 22, 26, 27};
+    CPPUNIT_ASSERT(expected == Index(s));
+}
+
+// =============================================================================
+
+void StructuralIndexTest::TestEscapes()
+{
+    //                   0 12 3 45 6 78 9 0
+    std::string_view s = "[\"\\\"\", \"\\\\\"]";
+    std::vector<uint32_t> expected{0, 1, 4, 5, 7, 10, 11, 12};
+    CPPUNIT_ASSERT(expected == Index(s));
+}
+
+// =============================================================================
+
+void StructuralIndexTest::TestUnterminatedString()
+{
+    std::vector<uint32_t> positions;
+    CPPUNIT_ASSERT(!detail::BuildStructuralIndex("[\"abc]", positions));
+    CPPUNIT_ASSERT(!detail::BuildStructuralIndex("[\"abc\\\"]", positions));
+    CPPUNIT_ASSERT_THROW(ParseFrom("{\"a\": \"b}"), JsonException);
+}
+
+// =============================================================================
+
+void StructuralIndexTest::TestSimdLevelsAgree()
+{
+    static const std::string alphabet = "{}[]:,\"\\ \t\n\rab01-.e";
+
+    std::mt19937 rng(7);
+    for (size_t iteration = 0; iteration < 2000; iteration++)
+    {
+        std::string s(rng() % 300, ' ');
+        for (char& c: s)
+            c = alphabet[rng() % alphabet.size()];
+
+        std::vector<uint32_t> scalar;
+        bool scalar_ok = detail::BuildStructuralIndex(s, scalar, detail::SimdLevel::Scalar);
+        for (detail::SimdLevel level: SupportedLevels())
+        {
+            std::vector<uint32_t> positions;
+            CPPUNIT_ASSERT_EQUAL(scalar_ok, detail::BuildStructuralIndex(s, positions, level));
+            CPPUNIT_ASSERT(scalar == positions);
+        }
+    }
+}
+
+// =============================================================================
+
+void StructuralIndexTest::TestBlockBoundaries()
+{
+    // Escapes, strings and tokens crossing 64-byte blocks
+    for (size_t pad = 50; pad < 80; pad++)
+    {
+        std::string s = "[";
+        s.append(pad, ' ');
+        s += "\"x\\\\\\\"y\", 12345, \"";
+        s.append(70, 'z');
+        s += "\"]";
+        JsonNode node = ParseFrom(s);
+        const JsonArray& array = node.AsArray();
+        CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), array.Size());
+        CPPUNIT_ASSERT_EQUAL(std::string("x\\\"y"), array[0].AsString());
+        CPPUNIT_ASSERT_EQUAL(12345, array[1].AsNumber().To<int>());
+        CPPUNIT_ASSERT_EQUAL(std::string(70, 'z'), array[2].AsString());
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -0,0 +1,134 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "tape.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class TapeTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(TapeTest);
+
+    CPPUNIT_TEST(TestScalars);
+    CPPUNIT_TEST(TestNavigation);
+    CPPUNIT_TEST(TestIteration);
+    CPPUNIT_TEST(TestMaterialize);
+    CPPUNIT_TEST(TestErrors);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestScalars();
+    void TestNavigation();
+    void TestIteration();
+    void TestMaterialize();
+    void TestErrors();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TapeTest);
+
+// =============================================================================
+
+void TapeTest::TestScalars()
+{
+    CPPUNIT_ASSERT(TapeDocument{"null"}.IsNull());
+    CPPUNIT_ASSERT_EQUAL(true, TapeDocument{" true "}.AsBool());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("a\"b\n"), TapeDocument{R"("a\"b\n")"}.AsString());
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-7), TapeDocument{"-7"}.AsNumber().To<int64_t>());
+    CPPUNIT_ASSERT_EQUAL(std::numeric_limits<uint64_t>::max(), TapeDocument{"18446744073709551615"}.AsNumber().To<uint64_t>());
+    CPPUNIT_ASSERT(AlmostEqual(-0.5, TapeDocument{"-5e-1"}.AsNumber()));
+    CPPUNIT_ASSERT(TapeDocument{"1.0"}.AsNumber().IsDouble());
+}
+
+// =============================================================================
+
+void TapeTest::TestNavigation()
+{
+    std::string input = R"({"skip": {"deep": [[1, 2], {"x": "y"}]}, "list": [10, "eleven", [], {}, 14], "last": false})";
+    TapeDocument doc{input};
+    input.assign(input.size(), ' ');
+
+    TapeObject root = doc.AsObject();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(3), root.Size());
+    CPPUNIT_ASSERT(root.Has("list"));
+    CPPUNIT_ASSERT(!root.Has("x"));
+    CPPUNIT_ASSERT_EQUAL(false, root["last"].AsBool());
+
+    TapeArray list = root["list"].AsArray();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(5), list.Size());
+    CPPUNIT_ASSERT_EQUAL(10, list[0].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("eleven"), list[1].AsString());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), list[2].AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), list[3].AsObject().Size());
+    CPPUNIT_ASSERT_EQUAL(14, list[4].AsNumber().To<int>());
+
+    CPPUNIT_ASSERT_EQUAL(std::string_view("y"), root["skip"].AsObject()["deep"].AsArray()[1].AsObject()["x"].AsString());
+}
+
+// =============================================================================
+
+void TapeTest::TestIteration()
+{
+    TapeDocument doc{R"({"a": [1, [2, 3], 4], "b": {"c": null}, "d": "e"})"};
+
+    std::string keys;
+    for (const auto& [key, value]: doc.AsObject())
+        keys += std::string{key} + (value.IsObject() ? "{};" : ";");
+    CPPUNIT_ASSERT_EQUAL(std::string("a;b{};d;"), keys);
+
+    int sum = 0;
+    for (const TapeValue& item: doc.AsObject()["a"].AsArray())
+        sum += item.IsNumber() ? item.AsNumber().To<int>() : 100;
+    CPPUNIT_ASSERT_EQUAL(105, sum);
+
+    TapeDocument empty{"[]"};
+    CPPUNIT_ASSERT(empty.AsArray().begin() == empty.AsArray().end());
+}
+
+// =============================================================================
+
+void TapeTest::TestMaterialize()
+{
+    TapeDocument doc{R"({"text": "line\nbreak", "numbers": [1, 2.5, -3], "nested": {"ok": true}})"};
+    JsonNode node = doc.Root().Materialize();
+
+    JsonObject& object = node.AsObject();
+    CPPUNIT_ASSERT_EQUAL(std::string("line\nbreak"), object["text"].AsString());
+    CPPUNIT_ASSERT_EQUAL(-3, object["numbers"].AsArray()[2].AsNumber().To<int>());
+    CPPUNIT_ASSERT_EQUAL(true, object["nested"].AsObject()["ok"].AsBool());
+}
+
+// =============================================================================
+
+void TapeTest::TestErrors()
+{
+    for (std::string bad: {"", "[1, 2", "{\"a\" 1}", R"("\x")", "[1] 2"})
+        CPPUNIT_ASSERT_THROW(TapeDocument{bad}, JsonException);
+    CPPUNIT_ASSERT_THROW(TapeDocument("[[[1]]]", JsonDeserializeOptions{.max_depth = 2}), JsonException);
+
+    TapeDocument doc{"[\"text\", 1]"};
+    CPPUNIT_ASSERT_THROW(doc.AsArray().At(2), JsonException);
+    CPPUNIT_ASSERT_THROW(doc.AsObject(), JsonException);
+    CPPUNIT_ASSERT_THROW(doc.AsArray()[0].AsNumber(), JsonException);
+    CPPUNIT_ASSERT_THROW(doc.AsArray()[1].AsString(), JsonException);
+    CPPUNIT_ASSERT_THROW(TapeDocument{"null"}.AsNumber(), JsonException);
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================
@@ -0,0 +1,154 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <string>
+
+#include "parser.hpp"
+#include "view.hpp"
+
+#include "common.hpp"
+
+// =============================================================================
+
+namespace mj::test
+{
+
+// =============================================================================
+
+class ViewTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(ViewTest);
+
+    CPPUNIT_TEST(TestViewsIntoBuffer);
+    CPPUNIT_TEST(TestEscapes);
+    CPPUNIT_TEST(TestContainers);
+    CPPUNIT_TEST(TestMaterialize);
+    CPPUNIT_TEST(TestErrors);
+
+    CPPUNIT_TEST_SUITE_END();
+
+protected:
+    void TestViewsIntoBuffer();
+    void TestEscapes();
+    void TestContainers();
+    void TestMaterialize();
+    void TestErrors();
+};
+
+// =============================================================================
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ViewTest);
+
+// =============================================================================
+
+namespace
+{
+
+bool IsInside(std::string_view view, const std::string& buffer)
+{
+    return view.data() >= buffer.data() && view.data() + view.size() <= buffer.data() + buffer.size();
+}
+
+template<typename Parse>
+std::string ErrorOf(Parse parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const JsonException& e)
+    {
+        return e.what();
+    }
+    return {};
+}
+
+} // namespace
+
+// =============================================================================
+
+void ViewTest::TestViewsIntoBuffer()
+{
+    std::string buffer = "{\"name\": \"value\", \"list\": [\"a\", \"b\"]}";
+    ViewNode node = ParseInSitu(buffer);
+
+    const ViewObject& object = node.AsObject();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("value"), object["name"].AsString());
+    CPPUNIT_ASSERT(IsInside(object["name"].AsString(), buffer));
+
+    for (const auto& [key, value]: object)
+        CPPUNIT_ASSERT(IsInside(key, buffer));
+    for (const ViewNode& item: object["list"].AsArray())
+        CPPUNIT_ASSERT(IsInside(item.AsString(), buffer));
+}
+
+// =============================================================================
+
+void ViewTest::TestEscapes()
+{
+    std::string buffer = R"(["a\"b\\c\/d", "\b\f\n\r\t", "\u0041\u00e9\u20AC", "\ud83d\ude00!", {"k\u0065y": 1}])";
+    ViewNode node = ParseInSitu(buffer);
+
+    const ViewArray& array = node.AsArray();
+    CPPUNIT_ASSERT_EQUAL(std::string_view("a\"b\\c/d"), array[0].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("\b\f\n\r\t"), array[1].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("A\xC3\xA9\xE2\x82\xAC"), array[2].AsString());
+    CPPUNIT_ASSERT_EQUAL(std::string_view("\xF0\x9F\x98\x80!"), array[3].AsString());
+    CPPUNIT_ASSERT(array[4].AsObject().Has("key"));
+}
+
+// =============================================================================
+
+void ViewTest::TestContainers()
+{
+    std::string buffer = " [1.5, true, null, [], {}, {\"a\": {\"b\": [false]}}] ";
+    ViewNode node = ParseInSitu(buffer);
+
+    const ViewArray& array = node.AsArray();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(6), array.Size());
+    CPPUNIT_ASSERT(AlmostEqual(1.5, array[0].AsNumber()));
+    CPPUNIT_ASSERT_EQUAL(true, array[1].AsBool());
+    CPPUNIT_ASSERT(array[2].IsNull());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), array[3].AsArray().Size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), array[4].AsObject().Size());
+    CPPUNIT_ASSERT_EQUAL(false, array[5].AsObject()["a"].AsObject()["b"].AsArray()[0].AsBool());
+
+    CPPUNIT_ASSERT_THROW(array.At(6), JsonException);
+    CPPUNIT_ASSERT_THROW(array[5].AsObject()["missing"], JsonException);
+}
+
+// =============================================================================
+
+void ViewTest::TestMaterialize()
+{
+    std::string buffer = "{\"text\": \"line\\nbreak\", \"numbers\": [1, 2, 3]}";
+    JsonNode node = ParseInSitu(buffer).Materialize();
+
+    CPPUNIT_ASSERT_EQUAL(std::string("line\nbreak"), node.AsObject()["text"].AsString());
+    CPPUNIT_ASSERT_EQUAL(3, node.AsObject()["numbers"].AsArray()[2].AsNumber().To<int>());
+}
+
+// =============================================================================
+
+void ViewTest::TestErrors()
+{
+    for (std::string bad: {"", "[1, 2", "{\"a\" 1}", R"("\x")", R"("\u12")", R"("\ud83d")", R"("\ude00")", "\"abc\\"})
+        CPPUNIT_ASSERT_THROW(ParseInSitu(bad), JsonException);
+
+    std::string deep = "[[[1]]]";
+    CPPUNIT_ASSERT_THROW(ParseInSitu(deep, JsonDeserializeOptions{.max_depth = 2}), JsonException);
+
+    // Escapes are reported where they are, like ParseFrom does
+    for (std::string bad: {R"({"text": "a\tb",
+"bad": "c\xd"})", R"({"a\q": 1})", R"(["ok", "\ud83d!"])"})
+    {
+        std::string expected = ErrorOf([&] { ParseFrom(bad); });
+        CPPUNIT_ASSERT(expected.find("invalid escape sequence at line") != std::string::npos);
+        CPPUNIT_ASSERT_EQUAL(expected, ErrorOf([&] { ParseInSitu(bad); }));
+    }
+}
+
+// =============================================================================
+
+} // namespace mj::test
+
+// =============================================================================